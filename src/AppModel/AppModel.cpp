@@ -8,13 +8,17 @@
 #include "Commands/ClipboardCommands.h"
 
 AppModel::AppModel()
-	: mLastTick(std::chrono::steady_clock::now())
-	, mPreviewManager(mTrackSet, mSoundBank)
-	, mProjectManager(mTransport, mSoundBank, mTrackSet, mRecordingSession)
+	: mProjectManager(mTransport, mSoundBank, mTrackSet, mRecordingSession)
 	, mMetronomeService(mSoundBank)
+	, mPreviewManager(mTrackSet, mSoundBank)
 {
+	// From here on the engine sends for the GUI, the GUI thread never waits on the output port
+	mSoundBank.SetOutputQueue(&mEngine.GetOutputQueue());
 	mMetronomeService.Initialize();
 
+	// AppModel keeps this device for its lifetime, port changes reopen it in place
+	mMidiInputManager.SetThruOutput(mSoundBank.GetMidiOutDevice().get());
+
 	// The ProjectManager uses callback to clear the undo history on 
 	// ClearProject() method calls and on LoadProject() method calls.
 	mProjectManager.SetClearUndoHistoryCallback([this]() {
@@ -37,6 +41,9 @@ AppModel::AppModel()
 // Called inside of MainFrame::OnTimer event
 void AppModel::Update()
 {
+	// Settings first, so a Start posted below plays the current tracks
+	SyncEngine();
+
 	switch (mTransport.GetState())
 	{
 	case Transport::State::StopRecording:	HandleStopRecording();		break;
@@ -50,9 +57,21 @@ void AppModel::Update()
 	case Transport::State::Rewinding:		HandleFastForwardRewind();	break;
 	}
 
+	// Without the sequencer thread the engine steps here, on the GUI timer
+	if (!mSequencerThread.IsRunning())
+	{
+		mEngine.Step();
+	}
+
+	HandleEngineEvents();
 	HandleIncomingMidi();
 }
 
+void AppModel::StartSequencerThread()
+{
+	mSequencerThread.Start([this]() { mEngine.Step(); }, std::chrono::microseconds(1000));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // NOTE EDIT PREVIEW FOR DRAG OPERATIONS
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -129,8 +148,7 @@ void AppModel::DeleteNote(const NoteLocation& note)
 {
 	if (!note.found) return;
 
-	Track& track = mTrackSet.GetTrack(note.trackIndex);
-	auto cmd = std::make_unique<DeleteNoteCommand>(track, note.noteOnIndex, note.noteOffIndex);
+	auto cmd = std::make_unique<DeleteNoteCommand>(mTrackSet, note);
 	mUndoRedoManager.ExecuteCommand(std::move(cmd));
 }
 
@@ -144,7 +162,7 @@ void AppModel::DeleteNotes(const std::vector<NoteLocation>& notes)
 
 void AppModel::ClearTrack(ubyte trackNumber)
 {
-	auto cmd = std::make_unique<ClearTrackCommand>(mTrackSet.GetTrack(trackNumber), trackNumber);
+	auto cmd = std::make_unique<ClearTrackCommand>(mTrackSet, trackNumber);
 	mUndoRedoManager.ExecuteCommand(std::move(cmd));
 }
 
@@ -155,9 +173,7 @@ void AppModel::MoveNote(const NoteLocation& note, uint64_t newStartTick, ubyte n
 	// Only create command if position actually changed
 	if (newStartTick == note.startTick && newPitch == note.pitch) return;
 
-	Track& track = mTrackSet.GetTrack(note.trackIndex);
-	auto cmd = std::make_unique<MoveNoteCommand>(
-		track, note.noteOnIndex, note.noteOffIndex, newStartTick, newPitch);
+	auto cmd = std::make_unique<MoveNoteCommand>(mTrackSet, note, newStartTick, newPitch);
 
 	mUndoRedoManager.ExecuteCommand(std::move(cmd));
 }
@@ -183,9 +199,7 @@ void AppModel::ResizeNote(const NoteLocation& note, uint64_t newDuration)
 	// Only create command if duration actually changed
 	if (newDuration == oldDuration) return;
 
-	Track& track = mTrackSet.GetTrack(note.trackIndex);
-
-	auto cmd = std::make_unique<ResizeNoteCommand>(track, note.noteOnIndex, note.noteOffIndex, newDuration);
+	auto cmd = std::make_unique<ResizeNoteCommand>(mTrackSet, note, newDuration);
 	mUndoRedoManager.ExecuteCommand(std::move(cmd));
 }
 
@@ -196,13 +210,11 @@ void AppModel::EditNoteVelocity(const NoteLocation& note, ubyte newVelocity)
 	// Only create command if velocity actually changed
 	if (newVelocity == note.velocity) return;
 
-	Track& track = mTrackSet.GetTrack(note.trackIndex);
-
-	auto cmd = std::make_unique<EditNoteVelocityCommand>(track, note.noteOnIndex, newVelocity);
+	auto cmd = std::make_unique<EditNoteVelocityCommand>(mTrackSet, note, newVelocity);
 	mUndoRedoManager.ExecuteCommand(std::move(cmd));
 
 	// Update the velocity in mSelection to reflect the new value
-	mSelection.UpdateVelocity(note.trackIndex, note.noteOnIndex, newVelocity);
+	mSelection.UpdateVelocity(note.id, newVelocity);
 }
 
 // Context-aware quantize: dispatch based on current state
@@ -319,7 +331,7 @@ int AppModel::TriggerDrumPad(int rowIndex)
 
 	// Play sound immediately (NoteOn only - let drum sound decay naturally)
 	MidiMessage noteOn = MidiMessage::NoteOn(row.pitch, 100, channel);  // Default velocity 100
-	mSoundBank.GetMidiOutDevice()->sendMessage(noteOn);
+	mSoundBank.SendMessage(noteOn);
 
 	// If loop is playing, enable the pad at the quantized column position
 	if (mTransport.IsPlaying() && mTransport.GetLoopSettings().enabled)
@@ -350,7 +362,7 @@ void AppModel::ReleaseDrumPad(int rowIndex)
 
 	// Send NoteOff
 	MidiMessage noteOff = MidiMessage::NoteOff(row.pitch, channel);
-	mSoundBank.GetMidiOutDevice()->sendMessage(noteOff);
+	mSoundBank.SendMessage(noteOff);
 }
 
 // Collision detection helper - single note exclusion
@@ -363,7 +375,7 @@ bool AppModel::IsRegionCollisionFree(uint64_t startTick, uint64_t endTick, ubyte
 
 	// If there's only one collision and it's the note we're excluding, that's fine
 	if (excludeNote && collisions.size() == 1 &&
-		collisions[0].noteOnIndex == excludeNote->noteOnIndex)
+		collisions[0] == *excludeNote)
 		return true;
 
 	return false;
@@ -383,7 +395,7 @@ bool AppModel::IsRegionCollisionFree(uint64_t startTick, uint64_t endTick, ubyte
 		bool isExcluded = false;
 		for (const auto& exclude : excludeNotes)
 		{
-			if (collision.noteOnIndex == exclude.noteOnIndex)
+			if (collision == exclude)
 			{
 				isExcluded = true;
 				break;
@@ -410,71 +422,248 @@ void AppModel::ReportError(const std::string& title, const std::string& msg, Err
 
 void AppModel::HandleIncomingMidi()
 {
-	auto message = mMidiInputManager.PollAndNotify(mTransport.GetCurrentTick());
-	if (!message) return;
+	// Thru sends from the input callback, keep its routing current
+	mMidiInputManager.SetThruMask(mSoundBank.GetLiveMask());
 
-	RouteAndPlayMessage(*message, mTransport.GetCurrentTick());
+	// Everything received since the last update, a chord arrives as several messages
+	uint64_t currentTick = mTransport.GetCurrentTick();
+	while (auto message = mMidiInputManager.PollAndNotify(currentTick))
+	{
+		RouteAndPlayMessage(*message, currentTick);
+	}
 }
 
-// Returns the change in time from lastTick's last value to now, then updates lastTick 
-uint64_t AppModel::GetDeltaTimeMs()
+void AppModel::RouteAndPlayMessage(const MidiMessage& mm, uint64_t currentTick)
 {
+	uint16_t liveMask = mSoundBank.GetLiveMask();
+	if (liveMask == 0) return;
 
-	auto now = std::chrono::steady_clock::now();
-	auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(now - mLastTick).count();
-	mLastTick = now;
-	return static_cast<uint64_t>(delta);
+	uint16_t recordMask = (mTransport.IsRecording() && mm.isMusicalMessage()) ? mSoundBank.GetRecordMask() : 0;
+	// With thru, the input callback already played channel messages
+	bool isThruSent = mMidiInputManager.IsThruEnabled() && mm.isChannelMessage();
+	for (ubyte c = 0; c < MidiConstants::CHANNEL_COUNT; c++)
+	{
+		uint16_t bit = static_cast<uint16_t>(1u << c);
+		if (!(liveMask & bit)) continue;
+
+		MidiMessage routed = mm;
+		routed.setChannel(c);
+		if (!isThruSent)
+		{
+			mSoundBank.SendMessage(routed);
+		}
+
+		if (recordMask & bit)
+		{
+			mRecordingSession.RecordEvent(routed, currentTick);
+		}
+	}
 }
 
-void AppModel::RouteAndPlayMessage(const MidiMessage& mm, uint64_t currentTick)
+void AppModel::SyncEngine()
 {
-	auto channels = mSoundBank.GetAllChannels();
-	bool isRecording = mTransport.IsRecording();
-	for (MidiChannel& c : channels)
+	EngineSync& sync = mEngineSync;
+
+	auto output = mSoundBank.GetMidiOutDevice();
+	if (output != sync.output && mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetOutput, .output = output}))
+	{
+		sync.output = output;
+	}
+
+	// Scheduled output: a sequencer connection to the current port, none while lookahead is off
+	bool scheduled = mOutputLookaheadMs > 0 && output;
+	if (scheduled && (!sync.scheduler || sync.scheduler->GetOutputPort() != output->getCurrentPort() ||
+		sync.lookaheadMs != mOutputLookaheadMs))
 	{
-		if (mSoundBank.ShouldChannelPlay(c, true))
+		auto scheduler = std::make_shared<AlsaSeqScheduler>(output->getCurrentPort());
+		if (!scheduler->IsOpen())
 		{
-			MidiMessage routed = mm;
-			routed.setChannel(c.channelNumber);
-			mSoundBank.GetMidiOutDevice()->sendMessage(routed);
+			mOutputLookaheadMs = 0;
+			ReportError("MIDI Output", "Could not open the ALSA sequencer, output is sent immediately.", ErrorLevel::Warning);
+		}
+		else if (mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetScheduler, .scheduler = scheduler,
+			.lookaheadMs = mOutputLookaheadMs}))
+		{
+			sync.scheduler = scheduler;
+			sync.lookaheadMs = mOutputLookaheadMs;
+		}
+	}
+	else if (!scheduled && sync.scheduler && mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetScheduler}))
+	{
+		sync.scheduler.reset();
+		sync.lookaheadMs = 0;
+	}
+
+	// Same pointer until a track is edited
+	auto tracks = mTrackSet.GetSnapshot();
+	if (tracks != sync.tracks && mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetTracks, .tracks = tracks}))
+	{
+		sync.tracks = tracks;
+	}
+
+	auto loop = mTransport.GetLoopSettings();
+	if (sync.loop != loop && mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetLoop, .loop = loop}))
+	{
+		sync.loop = loop;
+	}
+
+	// Same pointer until the tempo or time signature changes
+	const auto& tempoMap = mTransport.GetTempoMap();
+	if (tempoMap != sync.tempoMap && mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetTempoMap, .tempoMap = tempoMap}))
+	{
+		sync.tempoMap = tempoMap;
+	}
+
+	bool metronome = mMetronomeService.IsEnabled();
+	if (sync.metronome != metronome && mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetMetronome, .enabled = metronome}))
+	{
+		sync.metronome = metronome;
+	}
+
+	uint16_t channelMask = mSoundBank.GetPlayableMask();
+	if (sync.channelMask != channelMask && mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetChannelMask, .channelMask = channelMask}))
+	{
+		sync.channelMask = channelMask;
+	}
 
-			if (isRecording && c.record && routed.isMusicalMessage())
+	// Drum pattern at the ticks of the loop: a new copy whenever the pattern or loop start
+	// changes, none while muted or not looping
+	if (!mDrumMachine.IsMuted() && loop.enabled)
+	{
+		// Update loop duration (cheap - just sets flag if duration changed)
+		mDrumMachine.UpdatePattern(loop.endTick - loop.startTick);
+		const Track& pattern = mDrumMachine.GetPattern();
+		uint64_t version = mDrumMachine.GetPatternVersion();
+		if (!sync.drumPattern || sync.drumPatternVersion != version || sync.drumPatternStart != loop.startTick)
+		{
+			Track schedule = pattern;
+			for (auto& event : schedule)
+			{
+				event.tick += loop.startTick;
+			}
+			auto events = std::make_shared<const Track>(std::move(schedule));
+			if (mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetDrumPattern, .events = events}))
 			{
-				mRecordingSession.RecordEvent(routed, currentTick);
+				sync.drumPattern = events;
+				sync.drumPatternVersion = version;
+				sync.drumPatternStart = loop.startTick;
 			}
 		}
 	}
+	else if (sync.drumPattern && mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetDrumPattern}))
+	{
+		sync.drumPattern.reset();
+	}
+
+	// Recorded pass from a loop wrap that found the queue full
+	if (sync.pendingLoopBuffer && mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetLoopBuffer, .events = sync.pendingLoopBuffer}))
+	{
+		sync.pendingLoopBuffer.reset();
+	}
 }
 
-std::vector<MidiMessage> AppModel::PlayDrumMachinePattern(uint64_t lastTick, uint64_t currentTick)
+void AppModel::HandleEngineEvents()
 {
-	std::vector<MidiMessage> messages;
+	EngineEvent event;
+	while (mEngine.PollEvent(event))
+	{
+		switch (event.type)
+		{
+		case EngineEvent::Type::Position:
+			// Positions from before a stop or a user seek are stale
+			if (mEngineSync.playing && event.generation == mEngineSync.generation)
+			{
+				mTransport.ShiftToTick(event.tick);
+				mEngineSync.tick = event.tick;
+				mRecordingSession.SetPlayhead(event.tick, event.clockNs, mTransport.GetNsPerQuarter());
+			}
+			break;
+		case EngineEvent::Type::LoopWrapped:
+			if (mTransport.IsRecording())
+			{
+				HandleRecordingLoopWrap();
+			}
+			break;
+		case EngineEvent::Type::Release:
+			break;  // Reusing event frees what it released, here on the GUI thread
+		}
+	}
+}
 
-	// Update loop duration (cheap - just sets flag if duration changed)
-	auto loopSettings = mTransport.GetLoopSettings();
-	uint64_t loopDuration = loopSettings.endTick - loopSettings.startTick;
-	mDrumMachine.UpdatePattern(loopDuration);
+bool AppModel::StartEngine()
+{
+	uint64_t startTick = mTransport.StartPlayBack();
+	uint32_t generation = mEngineSync.generation + 1;
+	if (!mEngine.Post(EngineCommand{.type = EngineCommand::Type::Start, .tick = startTick, .generation = generation}))
+	{
+		return false;
+	}
 
-	// GetPattern() will regenerate if dirty
-	const Track& pattern = mDrumMachine.GetPattern();
+	mEngineSync.playing = true;
+	mEngineSync.generation = generation;
+	mEngineSync.tick = startTick;
+	SetRecordingPlayhead(startTick);
+	return true;
+}
 
-	// Find events between lastTick and currentTick (prevents missing events if tick jumps)
-	for (const auto& event : pattern)
+bool AppModel::StopEngine()
+{
+	if (!mEngineSync.playing) return true;
+	if (!mEngine.Post(EngineCommand{.type = EngineCommand::Type::Stop})) return false;
+
+	mEngineSync.playing = false;
+	mEngineSync.pendingLoopBuffer.reset();  // Stop drops the engine's loop buffer too
+	return true;
+}
+
+void AppModel::PostUserSeek()
+{
+	uint64_t tick = mTransport.GetCurrentTick();
+	if (tick == mEngineSync.tick) return;
+
+	uint32_t generation = mEngineSync.generation + 1;
+	if (mEngine.Post(EngineCommand{.type = EngineCommand::Type::Seek, .tick = tick, .generation = generation}))
 	{
-		// Drum pattern starts at 0, need to offset by loop's start tick for
-		// pattern to match loop region
-		uint64_t tick = event.tick + loopSettings.startTick;
-		if (tick >= lastTick && tick < currentTick)
-		{
-			messages.push_back(event.mm);
-		}
-		else if (tick > currentTick)
-		{
-			break;  // Pattern is sorted, no more events in range
-		}
+		mEngineSync.generation = generation;
+		mEngineSync.tick = tick;
+		SetRecordingPlayhead(tick);
+	}
+}
+
+void AppModel::HandleRecordingLoopWrap()
+{
+	const auto& loopSettings = mTransport.GetLoopSettings();
+
+	// Fix overlapping same-pitch notes to prevent merging artifacts
+	TrackSet::SeparateOverlappingNotes(mRecordingSession.GetBuffer());
+
+	// Wrap any notes still held at loop end to prevent stuck notes
+	// note offs will be added at the loop end, note ons will be added at loop start
+	uint64_t noteOffTick = loopSettings.endTick - MidiConstants::NOTE_SEPARATION_TICKS;
+	mRecordingSession.WrapActiveNotesAtLoop(noteOffTick, loopSettings.startTick);
+	mRecordingSession.SetPassRange(loopSettings.startTick, loopSettings.endTick);
+
+	// The engine plays this copy during the next pass.
+	// Notes recorded from now on are heard live through MIDI In, and from the pass after on.
+	// A newer pass replaces one still waiting for room in the queue.
+	auto buffer = std::make_shared<const Track>(mRecordingSession.GetBuffer());
+	mEngineSync.pendingLoopBuffer.reset();
+	if (!mEngine.Post(EngineCommand{.type = EngineCommand::Type::SetLoopBuffer, .events = buffer}))
+	{
+		mEngineSync.pendingLoopBuffer = buffer;
 	}
+}
+
+// Until the engine reports a position, the start or seek tick plays from now on
+void AppModel::SetRecordingPlayhead(uint64_t tick)
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	uint64_t nowNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+	mRecordingSession.SetPlayhead(tick, nowNs, mTransport.GetNsPerQuarter());
 
-	return messages;
+	const auto& loopSettings = mTransport.GetLoopSettings();
+	bool inLoop = loopSettings.enabled && tick < loopSettings.endTick;
+	mRecordingSession.SetPassRange(tick, inLoop ? loopSettings.endTick : UINT64_MAX);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -483,6 +672,8 @@ std::vector<MidiMessage> AppModel::PlayDrumMachinePattern(uint64_t lastTick, uin
 
 void AppModel::HandleStopRecording()
 {
+	// Stay in StopRecording and try again next update if the engine queue is full
+	if (!StopEngine()) return;
 	mTransport.SetState(Transport::State::Stopped);
 
 	// Close any notes still being held when stopping (prevents orphaned Note Ons)
@@ -500,124 +691,44 @@ void AppModel::HandleStopRecording()
 
 	// Always clear to ensure clean state for next recording
 	mRecordingSession.Clear();
-
-	mSoundBank.SilenceAllChannels();
 }
 
 void AppModel::HandleStopPlaying()
 {
+	// The engine silences all channels when it stops
+	if (!StopEngine()) return;
 	mTransport.SetState(Transport::State::Stopped);
-	mSoundBank.SilenceAllChannels();
 }
 
 void AppModel::HandleClickedPlay()
 {
-	// Call GetDeltaTimeMs:
-	// This sets mLastTick to now to prepare for playback 
-	// If call doesn't happen Delta would be HUGE 
-	// (total time when transport state was stopped)
-	// causing an unpredictable jump 
-	GetDeltaTimeMs();
-
-	mTrackSet.FindStart(mTransport.StartPlayBack());
+	// Stay in ClickedPlay and try again next update if the engine queue is full
+	if (!StartEngine()) return;
 	mTransport.SetState(Transport::State::Playing);
 }
 
 
 void AppModel::HandlePlaying()
 {
-	HandlePlaybackCore(false);
+	PostUserSeek();
 }
 
 void AppModel::HandleClickedRecord()
 {
-	// See HandleClickedPlay for reason behind GetDeltaTimeMs call
-	GetDeltaTimeMs();
-	// Move trackset iterators to start of playback based on the playhead tick
-	mTrackSet.FindStart(mTransport.StartPlayBack());
+	// See HandleClickedPlay
+	if (!StartEngine()) return;
 	mTransport.SetState(Transport::State::Recording);
 }
 
 void AppModel::HandleRecording()
 {
-	HandlePlaybackCore(true);
+	PostUserSeek();
 }
 
 void AppModel::HandleFastForwardRewind()
 {
+	// Shuttling from Playing or Recording: the engine stops until the button is released
+	if (!StopEngine()) return;
 	mSoundBank.SilenceAllChannels();
 	mTransport.ShiftCurrentTime();
 }
-
-void AppModel::HandlePlaybackCore(bool isRecording)
-{
-	std::vector<MidiMessage> messages;
-
-	uint64_t lastTick = mTransport.GetCurrentTick();
-	mTransport.UpdatePlayBack(GetDeltaTimeMs());
-	uint64_t currentTick = mTransport.GetCurrentTick();
-
-	// Get loop settings once
-	const auto& loopSettings = mTransport.GetLoopSettings();
-
-	// Loop-back logic (check BEFORE metronome to avoid double-click at loop boundary)
-	if (mTransport.ShouldLoopBack(currentTick))
-	{
-		// === RECORDING-SPECIFIC: Pre-wrap cleanup ===
-		// Must happen BEFORE the wrap to finalize events at the old loop end position
-		if (isRecording)
-		{
-			// Fix overlapping same-pitch notes to prevent merging artifacts
-			TrackSet::SeparateOverlappingNotes(mRecordingSession.GetBuffer());
-
-			// Wrap any notes still held at loop end to prevent stuck notes
-			// note offs will be added at the loop end, note ons will be added at loop start
-			uint64_t noteOffTick = loopSettings.endTick - MidiConstants::NOTE_SEPARATION_TICKS;
-			mRecordingSession.WrapActiveNotesAtLoop(noteOffTick, loopSettings.startTick);
-		}
-
-		// === COMMON: Perform the loop wrap (both playback and recording) ===
-		mTransport.ShiftToTick(loopSettings.startTick);
-		mTrackSet.FindStart(loopSettings.startTick);
-		uint64_t diff = currentTick - mTransport.GetCurrentTick();
-		currentTick = mTransport.GetCurrentTick();  // Update currentTick after loop-back
-		lastTick -= diff;
-
-		// === RECORDING-SPECIFIC: Post-wrap setup ===
-		// Must happen AFTER the wrap to initialize playback at the new loop start position
-		if (isRecording)
-		{
-			// Reset recording buffer iterator to loop start position for playback
-			mRecordingSession.ResetLoopPlayback(loopSettings.startTick);
-		}
-	}
-
-	// Metronome
-	if (mMetronomeService.IsEnabled())
-	{
-		auto beat = mTransport.CheckForBeat(lastTick, currentTick);
-		if (beat.beatOccurred)
-		{
-			mSoundBank.PlayMetronomeClick(beat.isDownbeat);
-		}
-	}
-
-	messages = mTrackSet.PlayBack(currentTick);
-
-	// During loop recording, also play back the recording buffer
-	// so you can hear what you recorded in previous loop iterations
-	if (isRecording && loopSettings.enabled)
-	{
-		auto loopMessages = mRecordingSession.GetLoopPlaybackMessages(currentTick);
-		messages.insert(messages.end(), loopMessages.begin(), loopMessages.end());
-	}
-
-	// Play drum machine pattern during loop playback
-	if (loopSettings.enabled && !mDrumMachine.IsMuted())
-	{
-		auto drumMessages = PlayDrumMachinePattern(lastTick, currentTick);
-		messages.insert(messages.end(), drumMessages.begin(), drumMessages.end());
-	}
-
-	mSoundBank.PlayMessages(messages);
-}
@@ -18,6 +18,8 @@
 #include "MetronomeService/MetronomeService.h"
 #include "DrumMachine/DrumMachine.h"
 #include "Selection/Selection.h"
+#include "Sequencer/PlaybackEngine.h"
+#include "Sequencer/SequencerThread.h"
 #include "MidiConstants.h"
 
 // Error Handling callback types
@@ -28,7 +30,8 @@ using ErrorCallback = std::function<void(const std::string& title, const std::st
 ///
 /// Responsibilities:
 /// - Coordinate all subsystems (Transport, TrackSet, SoundBank, etc.)
-/// - Handle the main update loop for playback and recording
+/// - Handle the main update loop for the transport and recording (GUI timer)
+/// - Feed the PlaybackEngine (GUI timer or sequencer thread) through its command queue
 /// - Execute commands through UndoRedoManager for undo/redo support
 /// - Provide collision detection for note editing
 /// - Route MIDI input to appropriate channels
@@ -43,9 +46,28 @@ public:
 	AppModel();
 
 	/// Main update loop - call from timer event.
-	/// Handles transport state machine and MIDI input.
+	/// Handles transport state machine, engine sync and MIDI input.
 	void Update();
 
+	// Sequencer Thread
+
+	/// Step the PlaybackEngine on a dedicated thread (1 ms deadlines) instead of in Update
+	void StartSequencerThread();
+
+	/// Stop the sequencer thread, Update steps the engine again
+	void StopSequencerThread() { mSequencerThread.Stop(); }
+
+	/// Check if the sequencer thread is stepping the engine
+	bool IsSequencerThreadRunning() const { return mSequencerThread.IsRunning(); }
+
+	// Output Scheduling
+
+	/// Queue playback output this far ahead with timestamps (ALSA sequencer), 0 sends immediately
+	void SetOutputLookahead(uint32_t ms) { mOutputLookaheadMs = ms; }
+
+	/// Lookahead of scheduled output in ms, 0 when output is sent immediately
+	uint32_t GetOutputLookahead() const { return mOutputLookaheadMs; }
+
 	// Note Edit Preview
 
 	/// Set preview for moving a single note (with collision detection)
@@ -140,7 +162,26 @@ public:
 	Selection& GetSelection() { return mSelection; }
 
 private:
-	std::chrono::steady_clock::time_point mLastTick;
+	/// What was last posted to the engine, Update posts whatever differs
+	struct EngineSync
+	{
+		bool playing = false;
+		uint32_t generation = 0;  // Of the last Start or Seek, older Position events are stale
+		uint64_t tick = 0;        // Playhead as last set from the engine, any other tick is a user seek
+		std::optional<Transport::LoopSettings> loop;
+		std::shared_ptr<const TempoMap> tempoMap;
+		std::optional<bool> metronome;
+		std::optional<uint16_t> channelMask;
+		std::shared_ptr<const TrackSnapshot> tracks;
+		std::shared_ptr<const Track> drumPattern;
+		uint64_t drumPatternVersion = 0;
+		uint64_t drumPatternStart = 0;  // Loop start the posted pattern was placed at
+		std::shared_ptr<const Track> pendingLoopBuffer;  // Recorded pass not posted yet, retried every update
+		std::shared_ptr<MidiOut> output;
+		std::shared_ptr<AlsaSeqScheduler> scheduler;
+		uint32_t lookaheadMs = 0;
+	};
+
 	SoundBank mSoundBank;
 	Transport mTransport;
 	TrackSet mTrackSet;
@@ -154,18 +195,41 @@ private:
 	DrumMachine mDrumMachine;
 	Selection mSelection;
 	ErrorCallback mErrorCallback;
+	PlaybackEngine mEngine;
+	EngineSync mEngineSync;
+	uint32_t mOutputLookaheadMs = 0;
+	SequencerThread mSequencerThread;  // Declared last so it is joined before the engine it steps is destroyed
 
-	/// Handle incoming MIDI messages from input device
+	/// Route and record every MIDI message received since the last update
 	void HandleIncomingMidi();
 
-	/// Get elapsed time since last call
-	uint64_t GetDeltaTimeMs();
-
 	/// Route a MIDI message to appropriate channels and record if needed
 	void RouteAndPlayMessage(const MidiMessage& mm, uint64_t currentTick);
 
-	/// Get drum machine messages for current tick range
-	std::vector<MidiMessage> PlayDrumMachinePattern(uint64_t lastTick, uint64_t currentTick);
+	// Playback Engine
+
+	/// Post settings, tracks, drum pattern, output device and scheduler to the engine when they changed
+	void SyncEngine();
+
+	/// Drain engine notifications: mirror the playhead, finish recorded loop passes
+	void HandleEngineEvents();
+
+	/// Start the engine at the transport's playhead
+	/// @return false if the command queue is full
+	bool StartEngine();
+
+	/// Stop the engine if it is playing (it silences all channels)
+	/// @return false if the command queue is full
+	bool StopEngine();
+
+	/// Post a seek when the playhead was moved by the user while playing
+	void PostUserSeek();
+
+	/// Close the recorded loop pass and send it to the engine for the next pass
+	void HandleRecordingLoopWrap();
+
+	/// Tell the recording session where the playhead is now (after a start or seek)
+	void SetRecordingPlayhead(uint64_t tick);
 
 	// Transport State Handlers
 
@@ -176,5 +240,4 @@ private:
 	void HandleClickedRecord();
 	void HandleRecording();
 	void HandleFastForwardRewind();
-	void HandlePlaybackCore(bool isRecording);
 };
@@ -18,7 +18,7 @@ public:
 	};
 
 	/// Copy notes to clipboard (converts NoteLocation to ClipboardNote)
-	void CopyNotes(const std::vector<NoteLocation>& notes, TrackSet& trackSet)
+	void CopyNotes(const std::vector<NoteLocation>& notes)
 	{
 		if (notes.empty()) return;
 
@@ -38,9 +38,6 @@ public:
 
 		for (const auto& note : notes)
 		{
-			Track& track = trackSet.GetTrack(note.trackIndex);
-			const TimedMidiEvent& noteOnEvent = track[note.noteOnIndex];
-
 			ClipboardNote clipNote;
 			clipNote.relativeStartTick = note.startTick - earliestTick;
 			clipNote.duration = note.endTick - note.startTick;
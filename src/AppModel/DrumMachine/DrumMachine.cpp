@@ -1,5 +1,6 @@
 // DrumMachine.cpp
 #include "DrumMachine.h"
+#include <algorithm>
 #include <cmath>
 
 void DrumMachine::SetColumnCount(int columns)
@@ -28,6 +29,7 @@ const Track& DrumMachine::GetPattern()
     {
         RegeneratePattern();
         mPatternDirty = false;
+        mPatternVersion++;
     }
     return mPattern;
 }
@@ -55,7 +57,19 @@ void DrumMachine::TogglePad(size_t rowIndex, size_t columnIndex)
 
     DrumPad& pad = GetPad(rowIndex, columnIndex);
     pad.enabled = !pad.enabled;
-    mPatternDirty = true;
+
+    // A pending rebuild picks the pad up
+    if (mPatternDirty) return;
+
+    if (pad.enabled)
+    {
+        InsertPadEvents(rowIndex, columnIndex);
+    }
+    else
+    {
+        RemovePadEvents(rowIndex, columnIndex);
+    }
+    mPatternVersion++;
 }
 
 void DrumMachine::EnablePad(size_t rowIndex, size_t columnIndex)
@@ -66,15 +80,28 @@ void DrumMachine::EnablePad(size_t rowIndex, size_t columnIndex)
     if (!pad.enabled)  // Only enable if not already enabled
     {
         pad.enabled = true;
-        mPatternDirty = true;
+        if (mPatternDirty) return;
+
+        InsertPadEvents(rowIndex, columnIndex);
+        mPatternVersion++;
     }
 }
 
 void DrumMachine::SetPadVelocity(size_t rowIndex, size_t columnIndex, ubyte velocity)
 {
     DrumPad& pad = GetPad(rowIndex, columnIndex);
+    ubyte previousVelocity = pad.velocity;
     pad.velocity = velocity;
-    mPatternDirty = true;
+    if (mPatternDirty || !pad.enabled) return;
+
+    // Only the NoteOn carries the velocity
+    uint64_t tick = columnIndex * CalculatePadDuration(mLastLoopDuration);
+    auto noteOn = FindEvent({MidiMessage::NoteOn(GetRow(rowIndex).pitch, previousVelocity, mChannel), tick});
+    if (noteOn != mPattern.end())
+    {
+        noteOn->mm.mData[2] = velocity;
+        mPatternVersion++;
+    }
 }
 
 bool DrumMachine::IsPadEnabled(size_t rowIndex, size_t columnIndex) const
@@ -92,7 +119,7 @@ void DrumMachine::Clear()
         }
     }
     mPattern.clear();
-    mPatternDirty = true;
+    mPatternVersion++;
 }
 
 bool DrumMachine::IsColumnOnMeasure(int column, uint64_t ticksPerMeasure) const
@@ -168,3 +195,45 @@ void DrumMachine::RegeneratePattern()
     TrackSet::SortTrack(mPattern);
 }
 
+void DrumMachine::InsertPadEvents(size_t rowIndex, size_t columnIndex)
+{
+    const DrumRow& row = GetRow(rowIndex);
+    const DrumPad& pad = GetPad(rowIndex, columnIndex);
+    uint64_t padDuration = CalculatePadDuration(mLastLoopDuration);
+    uint64_t tick = columnIndex * padDuration;
+
+    // Same events RegeneratePattern would produce, placed in track order
+    TimedMidiEvent noteOn{MidiMessage::NoteOn(row.pitch, pad.velocity, mChannel), tick};
+    TimedMidiEvent noteOff{MidiMessage::NoteOff(row.pitch, mChannel), tick + padDuration / 2};
+    for (const TimedMidiEvent& event : {noteOn, noteOff})
+    {
+        auto position = std::upper_bound(mPattern.begin(), mPattern.end(), event, TrackSet::EventPrecedes);
+        mPattern.insert(position, event);
+    }
+}
+
+void DrumMachine::RemovePadEvents(size_t rowIndex, size_t columnIndex)
+{
+    const DrumRow& row = GetRow(rowIndex);
+    const DrumPad& pad = GetPad(rowIndex, columnIndex);
+    uint64_t padDuration = CalculatePadDuration(mLastLoopDuration);
+    uint64_t tick = columnIndex * padDuration;
+
+    // Rows sharing a pitch have identical events, removing either one is the same
+    auto noteOn = FindEvent({MidiMessage::NoteOn(row.pitch, pad.velocity, mChannel), tick});
+    if (noteOn != mPattern.end()) mPattern.erase(noteOn);
+
+    auto noteOff = FindEvent({MidiMessage::NoteOff(row.pitch, mChannel), tick + padDuration / 2});
+    if (noteOff != mPattern.end()) mPattern.erase(noteOff);
+}
+
+Track::iterator DrumMachine::FindEvent(const TimedMidiEvent& event)
+{
+    auto found = std::lower_bound(mPattern.begin(), mPattern.end(), event.tick,
+        [](const TimedMidiEvent& e, uint64_t tick) { return e.tick < tick; });
+    for (; found != mPattern.end() && found->tick == event.tick; ++found)
+    {
+        if (found->mm == event.mm) return found;
+    }
+    return mPattern.end();
+}
@@ -28,6 +28,7 @@ public:
 	int GetColumnCount() const { return mColumnCount; }
 	void UpdatePattern(uint64_t loopDuration);	// Regenerate Track from Pads
 	const Track& GetPattern();  // Returns pattern, regenerates if dirty
+	uint64_t GetPatternVersion() const { return mPatternVersion; }  // Changes with every pattern edit (read after GetPattern)
 
 	// Row Management
 	void AddRow(const std::string& name, ubyte pitch);
@@ -40,7 +41,7 @@ public:
 	ubyte GetPitch(int row) const { return mRows[row].pitch; }
 	void SetPitch(int row, ubyte pitch) { mRows[row].pitch = pitch; mPatternDirty = true; }
 
-	// Pad Manipulation
+	// Pad Manipulation (edits the pattern in place, no rebuild)
 	void TogglePad(size_t rowIndex, size_t columnIndex);
 	void EnablePad(size_t rowIndex, size_t columnIndex);  // Enable specific pad (for live recording)
 	void SetPadVelocity(size_t rowIndex, size_t columnIndex, ubyte velocity);
@@ -70,9 +71,13 @@ private:
 	int mColumnCount = 16;
 	ubyte mChannel = 9;	// Channel 10 (index 9) for GM Drums
 	bool mIsMuted = true;
-	bool mPatternDirty = true;
+	bool mPatternDirty = true;	// Rows, columns, pitch, channel or loop length changed: rebuild
+	uint64_t mPatternVersion = 0;
 	uint64_t mLastLoopDuration = 15360;  // Default: 4 measures (3840 * 4)
 
 	void InitializeDefaultRows();
 	void RegeneratePattern();  // Actually rebuilds the pattern
+	void InsertPadEvents(size_t rowIndex, size_t columnIndex);  // Add one pad's NoteOn/NoteOff at their sorted positions
+	void RemovePadEvents(size_t rowIndex, size_t columnIndex);  // Remove one pad's NoteOn/NoteOff
+	Track::iterator FindEvent(const TimedMidiEvent& event);  // Pattern event with the same tick and bytes, or end
 };
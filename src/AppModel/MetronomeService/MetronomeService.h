@@ -38,8 +38,7 @@ public:
 		// Set channel 16 to woodblock sound for metronome
 		// We're using channel 16 (index METRONOME_CHANNEL) to avoid conflicts with user channels
 		// Program 115 = Woodblock (percussive, short click sound)
-		auto player = mSoundBank.GetMidiOutDevice();
-		player->sendMessage(MidiMessage::ProgramChange(115, MidiConstants::METRONOME_CHANNEL));
+		mSoundBank.SendMessage(MidiMessage::ProgramChange(115, MidiConstants::METRONOME_CHANNEL));
 	}
 
 	/// Check if metronome is enabled
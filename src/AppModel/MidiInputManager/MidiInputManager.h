@@ -5,15 +5,24 @@
 #include <memory>
 #include <functional>
 #include <optional>
+#include <atomic>
+#include <chrono>
 #include "RtMidiWrapper/MidiDevice/MidiIn.h"
+#include "RtMidiWrapper/MidiDevice/MidiOut.h"
 #include "AppModel/TrackSet/TrackSet.h"
+#include "AppModel/Sequencer/SpscQueue.h"
 
 /// MidiInputManager handles MIDI input device management.
 ///
 /// Responsibilities:
 /// - Manage MIDI input device
 /// - Provide port selection
-/// - Poll for incoming messages and notify callbacks
+/// - Queue incoming messages from RtMidi's input callback in a wait-free ring,
+///   stamped with their receive time (MidiMessage timestamp, steady_clock seconds)
+/// - Hand queued messages out in order and notify callbacks
+/// - Count queue depth and messages dropped on a full queue
+/// - MIDI thru: route channel messages to the live channels and send them from the
+///   callback itself, using a channel mask set from the GUI thread and a fixed output
 /// - Manage MIDI event logging callback
 ///
 /// Note: HandleIncomingMidi() in AppModel orchestrates the MIDI input flow
@@ -26,14 +35,23 @@
 ///   inputManager.SetLogCallback([](const TimedMidiEvent& event) {
 ///       LogPanel::Display(event);
 ///   });
+///   while (auto mm = inputManager.PollAndNotify(tick)) {}
 class MidiInputManager
 {
 public:
+	static constexpr size_t INPUT_QUEUE_CAPACITY = 1024;
+
 	MidiInputManager()
 		: mMidiIn(std::make_shared<MidiIn>())
 	{
+		mMidiIn->setMidiInCallback(&MidiInputManager::OnMidiIn, this);
 	}
 
+	~MidiInputManager() { mMidiIn->cancelCallback(); }
+
+	MidiInputManager(const MidiInputManager&) = delete;
+	MidiInputManager& operator=(const MidiInputManager&) = delete;
+
 	/// Get list of available MIDI input port names
 	/// @return Vector of port names
 	std::vector<std::string> GetPortNames() const { return mMidiIn->getPortNames(); }
@@ -61,14 +79,14 @@ public:
 	/// @return Current log callback (may be null)
 	const MidiLogCallback& GetLogCallback() const { return mLogCallback; }
 
-	/// Poll for incoming MIDI message and notify callback if received
+	/// Take the oldest received MIDI message and notify callback
+	/// Call until it returns std::nullopt to drain everything received since the last update
 	/// @param currentTick Current transport tick for timestamp
 	/// @return MIDI message if available, std::nullopt otherwise
 	std::optional<MidiMessage> PollAndNotify(uint64_t currentTick)
 	{
-		if (!mMidiIn->checkForMessage()) return std::nullopt;
-
-		MidiMessage mm = mMidiIn->getMessage();
+		MidiMessage mm;
+		if (!mQueue.TryPop(mm)) return std::nullopt;
 
 		if (mLogCallback)
 		{
@@ -78,8 +96,93 @@ public:
 		return mm;
 	}
 
+	// MIDI Thru
+
+	/// Send input from the input callback (true), or leave it to the GUI thread (false)
+	void SetThruEnabled(bool enabled) { mThruEnabled.store(enabled, std::memory_order_relaxed); }
+
+	/// Check if the input callback sends input
+	bool IsThruEnabled() const { return mThruEnabled.load(std::memory_order_relaxed); }
+
+	/// Bit per channel that plays live input (record enabled, mute/solo applied)
+	void SetThruMask(uint16_t mask) { mThruMask.store(mask, std::memory_order_relaxed); }
+
+	/// Output the input callback sends to; it must outlive this manager (AppModel passes
+	/// its SoundBank's device, which is destroyed after the input manager)
+	void SetThruOutput(MidiOut* output) { mThruOutput.store(output, std::memory_order_release); }
+
+	// Input Queue Statistics
+
+	/// Messages received and not yet polled
+	size_t GetQueueDepth() const { return mQueue.SizeApprox(); }
+
+	/// Most messages waiting at once so far
+	size_t GetPeakQueueDepth() const { return mPeakQueueDepth.load(std::memory_order_relaxed); }
+
+	/// Messages dropped because the queue was full
+	uint64_t GetDroppedCount() const { return mDroppedCount.load(std::memory_order_relaxed); }
+
 private:
 	std::shared_ptr<MidiIn> mMidiIn;
 	MidiLogCallback mLogCallback;
+	SpscQueue<MidiMessage, INPUT_QUEUE_CAPACITY> mQueue;  // RtMidi's input thread -> GUI thread
+	std::atomic<size_t> mPeakQueueDepth{0};   // Stored by the input thread only
+	std::atomic<uint64_t> mDroppedCount{0};   // Stored by the input thread only
+	std::atomic<bool> mThruEnabled{true};
+	std::atomic<uint16_t> mThruMask{0};
+	std::atomic<MidiOut*> mThruOutput{nullptr};
+
+	/// RtMidi input callback (RtMidi's input thread): queue the message, never block
+	static void OnMidiIn(double, std::vector<unsigned char>* message, void* userData)
+	{
+		// RtMidi's delta time is relative to the previous message, an absolute receive
+		// time can be compared with the playhead
+		auto received = std::chrono::steady_clock::now().time_since_epoch();
+		auto* self = static_cast<MidiInputManager*>(userData);
+		size_t size = message->size();
+		// Channel and system common messages only, RtMidi filters SysEx by default
+		if (size == 0 || size > 3) return;
+
+		MidiMessage mm((*message)[0], size > 1 ? (*message)[1] : 0, size > 2 ? (*message)[2] : 0);
+		mm.setTimestamp(std::chrono::duration<double>(received).count());
+		if (self->IsThruEnabled())
+		{
+			self->SendThru(mm);
+		}
+		if (!self->mQueue.TryPush(mm))
+		{
+			self->mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		size_t depth = self->mQueue.SizeApprox();
+		if (depth > self->mPeakQueueDepth.load(std::memory_order_relaxed))
+		{
+			self->mPeakQueueDepth.store(depth, std::memory_order_relaxed);
+		}
+	}
+
+	/// Send a channel message on every thru channel (input thread)
+	void SendThru(const MidiMessage& mm)
+	{
+		// System messages have no channel to route, the GUI thread sends them
+		if (!mm.isChannelMessage()) return;
+
+		uint16_t mask = mThruMask.load(std::memory_order_relaxed);
+		if (mask == 0) return;
+
+		MidiOut* output = mThruOutput.load(std::memory_order_acquire);
+		if (!output) return;
+
+		for (ubyte c = 0; c < MidiConstants::CHANNEL_COUNT; c++)
+		{
+			if (mask & (1u << c))
+			{
+				MidiMessage routed = mm;
+				routed.setChannel(c);
+				output->sendMessage(routed);
+			}
+		}
+	}
 };
 
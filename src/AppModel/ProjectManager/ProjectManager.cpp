@@ -7,7 +7,9 @@
 #include "AppModel/RecordingSession/RecordingSession.h"
 #include "MidiConstants.h"
 #include "External/json.hpp"
+#include <algorithm>
 #include <fstream>
+#include <utility>
 #include "External/midifile/MidiFile.h"
 
 using json = nlohmann::json;
@@ -47,6 +49,22 @@ bool ProjectManager::SaveProject(const std::string& filepath)
 			{"currentTick", mTransport.GetCurrentTick()}
 		};
 
+		// Changes after the start of the song (tempo map)
+		const auto& segments = mTransport.GetTempoMap()->GetSegments();
+		if (segments.size() > 1)
+		{
+			json changes = json::array();
+			for (size_t i = 1; i < segments.size(); i++)
+			{
+				changes.push_back({
+					{"tick", segments[i].tick},
+					{"tempo", segments[i].tempo},
+					{"timeSignature", {segments[i].numerator, segments[i].denominator}}
+				});
+			}
+			project["transport"]["tempoChanges"] = changes;
+		}
+
 		// 2. Channels (CHANNEL_COUNT channels, 0-14)
 		project["channels"] = json::array();
 		auto channels = mSoundBank.GetAllChannels();
@@ -62,9 +80,9 @@ bool ProjectManager::SaveProject(const std::string& filepath)
 				{"minimized", ch.minimized},
 				{"customName", ch.customName},
 				{"customColor", {
-					{"r", ch.customColor.Red()},
-					{"g", ch.customColor.Green()},
-					{"b", ch.customColor.Blue()}
+					{"r", ch.customColor.red},
+					{"g", ch.customColor.green},
+					{"b", ch.customColor.blue}
 				}}
 			});
 		}
@@ -73,7 +91,7 @@ bool ProjectManager::SaveProject(const std::string& filepath)
 		project["tracks"] = json::array();
 		for (int i = 0; i < MidiConstants::CHANNEL_COUNT; i++) 
 		{
-			Track& track = mTrackSet.GetTrack(i);
+			const Track& track = std::as_const(mTrackSet).GetTrack(i);
 			json trackJson;
 			trackJson["channel"] = i;
 			trackJson["events"] = json::array();
@@ -146,11 +164,23 @@ bool ProjectManager::LoadProject(const std::string& filepath)
 		// TODO: Handle different versions if needed
 
 		// 1. Transport
-		Transport::BeatSettings beatSettings;
-		beatSettings.tempo = project["transport"]["tempo"];
-		beatSettings.timeSignatureNumerator = project["transport"]["timeSignature"][0];
-		beatSettings.timeSignatureDenominator = project["transport"]["timeSignature"][1];
-		mTransport.SetBeatSettings(beatSettings);
+		std::vector<TempoMap::Segment> segments(1);
+		segments[0].tempo = project["transport"]["tempo"];
+		segments[0].numerator = project["transport"]["timeSignature"][0];
+		segments[0].denominator = project["transport"]["timeSignature"][1];
+
+		// Optional: tempo map (projects saved before it had one tempo)
+		if (project["transport"].contains("tempoChanges")) {
+			for (const auto& change : project["transport"]["tempoChanges"]) {
+				TempoMap::Segment segment;
+				segment.tick = change["tick"];
+				segment.tempo = change["tempo"];
+				segment.numerator = change["timeSignature"][0];
+				segment.denominator = change["timeSignature"][1];
+				segments.push_back(segment);
+			}
+		}
+		mTransport.SetTempoMap(std::make_shared<const TempoMap>(std::move(segments)));
 
 		// Optional: Restore playback position
 		if (project["transport"].contains("currentTick")) {
@@ -180,11 +210,12 @@ bool ProjectManager::LoadProject(const std::string& filepath)
 				unsigned char r = chJson["customColor"]["r"];
 				unsigned char g = chJson["customColor"]["g"];
 				unsigned char b = chJson["customColor"]["b"];
-				ch.customColor = wxColour(r, g, b);
+				ch.customColor = ChannelColor{r, g, b};
 			}
 		}
 
 		// IMPORTANT: Apply channel settings to MIDI device
+		mSoundBank.UpdateChannelMasks();
 		mSoundBank.ApplyChannelSettings();
 
 		// 3. Tracks
@@ -254,7 +285,7 @@ void ProjectManager::ClearProject()
 	mTransport.SetState(Transport::State::Stopped);
 
 	// Reset transport to defaults
-	mTransport.SetBeatSettings(Transport::BeatSettings());  // Reset to defaults
+	mTransport.SetTempoMap(std::make_shared<const TempoMap>());  // Reset to defaults
 	mTransport.Reset();
 
 	// Clear all tracks
@@ -277,6 +308,7 @@ void ProjectManager::ClearProject()
 		ch.customName = "";
 		ch.customColor = TRACK_COLORS[i];
 	}
+	mSoundBank.UpdateChannelMasks();
 	mSoundBank.ApplyChannelSettings();
 
 	// Silence all channels
@@ -324,18 +356,27 @@ bool ProjectManager::ExportMIDI(const std::string& filepath)
 		std::vector<ubyte> midievent;
 		midievent.resize(3);
 
-		auto beatSettings = mTransport.GetBeatSettings();
-
 		midifile.setTPQ(960);	// Ticks Per Quarter
 
-		// Add tempo and time signature to track 0
-		midifile.addTempo(0, 0, beatSettings.tempo);
-		midifile.addTimeSignature(0, 0, beatSettings.timeSignatureNumerator, beatSettings.timeSignatureDenominator);
+		// Add tempo and time signature changes to track 0
+		const TempoMap::Segment* previous = nullptr;
+		for (const auto& segment : mTransport.GetTempoMap()->GetSegments())
+		{
+			if (!previous || segment.tempo != previous->tempo)
+			{
+				midifile.addTempo(0, segment.tick, segment.tempo);
+			}
+			if (!previous || segment.numerator != previous->numerator || segment.denominator != previous->denominator)
+			{
+				midifile.addTimeSignature(0, segment.tick, segment.numerator, segment.denominator);
+			}
+			previous = &segment;
+		}
 
 		// Export each track
 		for (int i = 0; i < MidiConstants::CHANNEL_COUNT; i++)
 		{
-			Track& track = mTrackSet.GetTrack(i);
+			const Track& track = std::as_const(mTrackSet).GetTrack(i);
 			if (track.empty()) continue;
 
 			int tracknum = midifile.addTrack();
@@ -443,44 +484,53 @@ bool ProjectManager::ImportMIDI(const std::string& filepath)
 			mTrackSet.GetTrack(i).clear();
 		}
 
-		// Extract tempo from first tempo event (if present)
-		double tempo = 120.0;  // Default tempo
+		// Collect every tempo and time signature change (any track, converted ticks)
+		struct MetaChange
+		{
+			uint64_t tick;
+			bool isTempo;
+			double tempo;
+			int numerator;
+			int denominator;
+		};
+		std::vector<MetaChange> metaChanges;
 		for (int track = 0; track < midifile.getTrackCount(); track++)
 		{
 			for (int event = 0; event < midifile[track].size(); event++)
 			{
-				if (midifile[track][event].isTempo())
+				auto& midiEvent = midifile[track][event];
+				uint64_t tick = (uint64_t)(midiEvent.tick * tickConversion);
+				if (midiEvent.isTempo())
+				{
+					metaChanges.push_back({tick, true, midiEvent.getTempoBPM(), 0, 0});
+				}
+				else if (midiEvent.isTimeSignature())
 				{
-					tempo = midifile[track][event].getTempoBPM();
-					break;
+					metaChanges.push_back({tick, false, 0.0, midiEvent[3], (int)pow(2, midiEvent[4])});
 				}
 			}
-			if (tempo != 120.0) break;
 		}
+		std::stable_sort(metaChanges.begin(), metaChanges.end(),
+			[](const MetaChange& a, const MetaChange& b) { return a.tick < b.tick; });
 
-		// Extract time signature from first time signature event (if present)
-		int timeSignatureNumerator = 4;    // Default 4/4
-		int timeSignatureDenominator = 4;
-		for (int track = 0; track < midifile.getTrackCount(); track++)
+		// Build the tempo map, each change keeps what the other kind was at that point
+		std::vector<TempoMap::Segment> segments(1);
+		for (const auto& change : metaChanges)
 		{
-			for (int event = 0; event < midifile[track].size(); event++)
+			TempoMap::Segment segment = segments.back();
+			segment.tick = change.tick;
+			if (change.isTempo)
 			{
-				if (midifile[track][event].isTimeSignature())
-				{
-					timeSignatureNumerator = midifile[track][event][3];
-					timeSignatureDenominator = (int)pow(2, midifile[track][event][4]);
-					break;
-				}
+				segment.tempo = change.tempo;
+			}
+			else
+			{
+				segment.numerator = change.numerator;
+				segment.denominator = change.denominator;
 			}
-			if (timeSignatureNumerator != 4) break;
+			segments.push_back(segment);
 		}
-
-		// Update Transport settings
-		Transport::BeatSettings beatSettings;
-		beatSettings.tempo = tempo;
-		beatSettings.timeSignatureNumerator = timeSignatureNumerator;
-		beatSettings.timeSignatureDenominator = timeSignatureDenominator;
-		mTransport.SetBeatSettings(beatSettings);
+		mTransport.SetTempoMap(std::make_shared<const TempoMap>(std::move(segments)));
 
 		// Import each track's events
 		for (int trackNum = 0; trackNum < midifile.getTrackCount(); trackNum++)
@@ -532,6 +582,22 @@ bool ProjectManager::ImportMIDI(const std::string& filepath)
 			}
 		}
 
+		// A channel can be spread over several SMF tracks, restore tick order per channel
+		for (int i = 0; i < MidiConstants::CHANNEL_COUNT; i++)
+		{
+			TrackSet::SortTrack(mTrackSet.GetTrack(i));
+		}
+
+		// Log how much memory the imported events take, and what the compact encoding would take
+		std::ofstream memoryLog("import-midi.log", std::ios::app);
+		if (memoryLog.is_open())
+		{
+			TrackSet::MemoryReport report = mTrackSet.GetMemoryReport();
+			memoryLog << "\nImported Events: " << report.eventCount << "\n";
+			memoryLog << "Track Memory (bytes): " << report.trackBytes << "\n";
+			memoryLog << "Compact Memory (bytes): " << report.compactBytes << "\n";
+		}
+
 		// Apply the imported program changes to MIDI device
 		mSoundBank.ApplyChannelSettings();
 
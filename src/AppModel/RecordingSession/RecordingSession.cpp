@@ -6,14 +6,13 @@
 void RecordingSession::Clear()
 {
 	mBuffer.clear();
-	mBufferIterator = -1;
 	mActiveNotes.clear();
 }
 
 void RecordingSession::RecordEvent(const MidiMessage& msg, uint64_t currentTick)
 {
 	// Add to recording buffer
-	TimedMidiEvent recordedEvent{msg, currentTick};
+	TimedMidiEvent recordedEvent{msg, GetReceiveTick(msg, currentTick)};
 	AddEvent(recordedEvent);
 	ubyte velocity = msg.getVelocity();
 
@@ -28,17 +27,25 @@ void RecordingSession::RecordEvent(const MidiMessage& msg, uint64_t currentTick)
 	}
 }
 
+void RecordingSession::SetPlayhead(uint64_t tick, uint64_t timeNs, uint64_t nsPerQuarter)
+{
+	mPlayheadTick = tick;
+	mPlayheadNs = timeNs;
+	mNsPerQuarter = nsPerQuarter;
+}
+
 void RecordingSession::WrapActiveNotesAtLoop(uint64_t endTick, uint64_t loopStartTick)
 {
 	for (auto& note : mActiveNotes)  // Note: not const, we modify tick 
 	{
 		// Close the note at loop end
 		MidiMessage noteOff = MidiMessage::NoteOff(note.mm.getPitch(), note.mm.getChannel());
-		mBuffer.push_back({noteOff, endTick});
+		InsertSorted({noteOff, endTick});
 
 		// Reopen the note at loop start (user still holding key)
 		// note.mm already IS the Note On message - just reuse it!
-		mBuffer.push_back({note.mm, loopStartTick});
+		// Inserted in tick order so the loop playback cursor can binary search the buffer
+		InsertSorted({note.mm, loopStartTick});
 
 		// Update active note's start tick for eventual release
 		note.tick = loopStartTick;
@@ -58,43 +65,41 @@ void RecordingSession::CloseAllActiveNotes(uint64_t endTick)
 	mActiveNotes.clear();
 }
 
-void RecordingSession::ResetLoopPlayback(uint64_t loopStartTick)
+// The GUI polls input and learns the playhead once per update, receive times place notes
+// between updates. Messages received before a loop wrap but handled after it go to the
+// start of the new pass, the finished pass was already handed to playback.
+uint64_t RecordingSession::GetReceiveTick(const MidiMessage& msg, uint64_t currentTick) const
 {
-	// Handle case where user enables loop recording but hasn't played anything yet
-	// (e.g., waiting through one or more loop iterations before adding notes)
-	if (mBuffer.empty())
+	if (msg.timestamp <= 0.0 || mNsPerQuarter == 0) return currentTick;
+
+	uint64_t receivedNs = static_cast<uint64_t>(msg.timestamp * 1e9);
+	receivedNs = (receivedNs > mInputLatencyNs) ? receivedNs - mInputLatencyNs : 0;
+
+	// Ticks in a duration, split so the product can't overflow
+	auto toTicks = [this](uint64_t ns)
 	{
-		return;  // Iterator will remain -1 from previous Clear() or construction
-	}
+		constexpr uint64_t tpq = MidiConstants::TICKS_PER_QUARTER;
+		return (ns / mNsPerQuarter) * tpq + (ns % mNsPerQuarter) * tpq / mNsPerQuarter;
+	};
 
-	// Find first event at or after loop start position
-	int i = 0;
-	while (i < mBuffer.size() && mBuffer[i].tick < loopStartTick)
+	uint64_t tick;
+	if (receivedNs >= mPlayheadNs)
 	{
-		i++;
+		tick = mPlayheadTick + toTicks(receivedNs - mPlayheadNs);
 	}
-	mBufferIterator = (i < mBuffer.size()) ? i : -1;
-}
-
-std::vector<MidiMessage> RecordingSession::GetLoopPlaybackMessages(uint64_t currentTick)
-{
-	std::vector<MidiMessage> messages;
-
-	// Process all events at or before currentTick
-	while (mBufferIterator != -1 &&
-		mBufferIterator < mBuffer.size() &&
-		mBuffer[mBufferIterator].tick <= currentTick)
+	else
 	{
-		messages.push_back(mBuffer[mBufferIterator].mm);
-		mBufferIterator++;
-		if (mBufferIterator >= mBuffer.size())
-		{
-			mBufferIterator = -1;
-			break;
-		}
+		uint64_t before = toTicks(mPlayheadNs - receivedNs);
+		tick = (before < mPlayheadTick) ? mPlayheadTick - before : 0;
 	}
 
-	return messages;
+	return std::clamp(tick, mPassStartTick, std::max(mPassStartTick, mPassEndTick - 1));
+}
+
+void RecordingSession::InsertSorted(const TimedMidiEvent& event)
+{
+	auto pos = std::upper_bound(mBuffer.begin(), mBuffer.end(), event, TrackSet::EventPrecedes);
+	mBuffer.insert(pos, event);
 }
 
 void RecordingSession::StopNote(ubyte channel, ubyte pitch)
@@ -17,15 +17,26 @@ public:
 	const Track& GetBuffer() const { return mBuffer; }
 	/// Is the recording buffer empty?
 	bool IsEmpty() const { return mBuffer.empty(); }
-	/// clear the recording buffer and active notes list, and reset the iterator
+	/// clear the recording buffer and active notes list
 	void Clear();
 
 	// Recording to buffer
 
-	/// Records midi messages to the buffer
+	/// Records midi messages to the buffer at the tick they were received
+	/// (currentTick if the message has no receive time)
 	/// if message is a NOTE ON event, update the active notes list 
 	void RecordEvent(const MidiMessage& msg, uint64_t currentTick);
 
+	// Receive time to tick conversion
+
+	/// Playhead reference: tick was playing at steady_clock time timeNs, at nsPerQuarter tempo
+	void SetPlayhead(uint64_t tick, uint64_t timeNs, uint64_t nsPerQuarter);
+	/// Recorded ticks are kept within the pass being recorded, [startTick, endTick)
+	void SetPassRange(uint64_t startTick, uint64_t endTick) { mPassStartTick = startTick; mPassEndTick = endTick; }
+	/// Fixed input latency (interface and driver), subtracted from receive times
+	void SetInputLatency(uint32_t ms) { mInputLatencyNs = ms * 1'000'000ull; }
+	uint32_t GetInputLatency() const { return static_cast<uint32_t>(mInputLatencyNs / 1'000'000); }
+
 	/// When we reach the end of the loop region: 
 	/// Close held notes at loop end (adds NOTE_OFF events),
 	/// and then wraps the active notes (adds (NOTE_ON events) to loop start
@@ -38,28 +49,28 @@ public:
 	/// Are there notes currently held down?
 	bool HasActiveNotes() const { return !mActiveNotes.empty(); }
 	const std::vector<TimedMidiEvent>& GetActiveNotes() const { return mActiveNotes; }
-	
-	// Loop recording playback (plays back previously recorded material during loop recording)
-
-	/// Resets the iterator to the first midi event in the loop region
-	void ResetLoopPlayback(uint64_t loopStartTick);
-	
-	/// Get the list of notes that are scheduled for playback in recording buffer	
-	/// Note: We only listen to recording buffer messages after they've been added to buffer 
-	/// - and we've looped back to them.  
-	/// - Midi In Playback handles hearing the notes the first time (during their actual recording)
-	std::vector<MidiMessage> GetLoopPlaybackMessages(uint64_t currentTick);
 
 private:
 	Track mBuffer;
-	int mBufferIterator = -1;
 	/// Active note tracking - displayed as light up piano keys
 	/// also used for loop recording - can check active notes and prevent them from
 	/// sticking at loop boundaries
 	std::vector<TimedMidiEvent> mActiveNotes;
+
+	uint64_t mPlayheadTick = 0;
+	uint64_t mPlayheadNs = 0;
+	uint64_t mNsPerQuarter = 0;  // 0 until a playhead is set: record at currentTick
+	uint64_t mPassStartTick = 0;
+	uint64_t mPassEndTick = UINT64_MAX;
+	uint64_t mInputLatencyNs = 0;
+
+	/// Tick a message was played at, from its receive time (MidiMessage timestamp, steady_clock seconds)
+	uint64_t GetReceiveTick(const MidiMessage& msg, uint64_t currentTick) const;
 	
 	/// Add a timed midi event to the recording buffer during recording
 	void AddEvent(const TimedMidiEvent& event) { mBuffer.push_back(event); }
+	/// Insert an event in track order, see TrackSet::EventPrecedes (keeps a sorted buffer sorted)
+	void InsertSorted(const TimedMidiEvent& event);
 	/// Adds note to active notes vector	
 	void StartNote(const TimedMidiEvent& note) { mActiveNotes.push_back(note); }
 	/// Removes the active note with the given channel and pitch
@@ -58,11 +58,11 @@ public:
 	const std::vector<NoteLocation>& GetNotes() const { return mSelectedNotes; }
 
 	/// Update the velocity of a note in selection, used when user drags velocity control
-	void UpdateVelocity(ubyte trackIndex, int noteOnIndex, ubyte newVelocity)
+	void UpdateVelocity(NoteId id, ubyte newVelocity)
 	{
 		for (auto& note : mSelectedNotes)
 		{
-			if (note.trackIndex == trackIndex && note.noteOnIndex == noteOnIndex)
+			if (note.id == id)
 			{
 				note.velocity = newVelocity;
 				break;
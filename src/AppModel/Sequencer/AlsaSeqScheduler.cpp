@@ -0,0 +1,188 @@
+// AlsaSeqScheduler.cpp
+#include "AlsaSeqScheduler.h"
+
+#if defined(__LINUX_ALSA__)
+#include <alsa/asoundlib.h>
+
+bool AlsaSeqScheduler::IsSupported()
+{
+	return true;
+}
+
+AlsaSeqScheduler::AlsaSeqScheduler(unsigned int outputPort)
+	: mOutputPort(outputPort)
+{
+	snd_seq_t* seq = nullptr;
+	if (snd_seq_open(&seq, "default", SND_SEQ_OPEN_OUTPUT, 0) < 0) return;
+	snd_seq_set_client_name(seq, "MidiWorks Scheduler");
+
+	int client = 0;
+	int port = 0;
+	mSeq = seq;
+	mPort = snd_seq_create_simple_port(seq, "Scheduled Out",
+		SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ,
+		SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+	mQueue = snd_seq_alloc_named_queue(seq, "MidiWorks");
+
+	if (mPort < 0 || mQueue < 0 || !FindDestination(outputPort, client, port) ||
+		snd_seq_connect_to(seq, mPort, client, port) < 0 ||
+		snd_midi_event_new(16, &mEncoder) < 0)
+	{
+		if (mQueue >= 0) snd_seq_free_queue(seq, mQueue);
+		snd_seq_close(seq);
+		mSeq = nullptr;
+		mEncoder = nullptr;
+		return;
+	}
+
+	snd_seq_start_queue(seq, mQueue, nullptr);
+	snd_seq_drain_output(seq);
+}
+
+AlsaSeqScheduler::~AlsaSeqScheduler()
+{
+	if (!mSeq) return;
+
+	CancelPending();
+	snd_seq_stop_queue(mSeq, mQueue, nullptr);
+	snd_seq_drain_output(mSeq);
+	snd_seq_free_queue(mSeq, mQueue);
+	snd_midi_event_free(mEncoder);
+	snd_seq_close(mSeq);
+}
+
+uint64_t AlsaSeqScheduler::GetTimeNs() const
+{
+	if (!mSeq) return 0;
+
+	snd_seq_queue_status_t* status;
+	snd_seq_queue_status_alloca(&status);
+	if (snd_seq_get_queue_status(mSeq, mQueue, status) < 0) return 0;
+
+	const snd_seq_real_time_t* time = snd_seq_queue_status_get_real_time(status);
+	return static_cast<uint64_t>(time->tv_sec) * 1'000'000'000ull + time->tv_nsec;
+}
+
+void AlsaSeqScheduler::Schedule(const MidiMessage& mm, uint64_t timeNs)
+{
+	if (!mSeq) return;
+
+	snd_seq_event_t event;
+	snd_seq_ev_clear(&event);
+	snd_midi_event_reset_encode(mEncoder);
+	if (snd_midi_event_encode(mEncoder, mm.mData, mm.getMessageSize(), &event) <= 0 ||
+		event.type == SND_SEQ_EVENT_NONE)
+	{
+		return;
+	}
+	// A NoteOn with velocity 0 is a NoteOff, CancelPending must keep it
+	if (event.type == SND_SEQ_EVENT_NOTEON && event.data.note.velocity == 0)
+	{
+		event.type = SND_SEQ_EVENT_NOTEOFF;
+	}
+
+	snd_seq_real_time_t time;
+	time.tv_sec = static_cast<unsigned int>(timeNs / 1'000'000'000ull);
+	time.tv_nsec = static_cast<unsigned int>(timeNs % 1'000'000'000ull);
+
+	snd_seq_ev_set_source(&event, mPort);
+	snd_seq_ev_set_subs(&event);
+	snd_seq_ev_schedule_real(&event, mQueue, 0, &time);
+	snd_seq_event_output(mSeq, &event);
+}
+
+void AlsaSeqScheduler::Flush()
+{
+	if (!mSeq) return;
+	snd_seq_drain_output(mSeq);
+}
+
+void AlsaSeqScheduler::CancelPending()
+{
+	if (!mSeq) return;
+
+	// Events still in our output buffer and events waiting in the kernel queue.
+	// snd_seq_drop_output would also throw away NoteOffs, leaving notes hanging.
+	snd_seq_remove_events_t* remove;
+	snd_seq_remove_events_alloca(&remove);
+	snd_seq_remove_events_set_queue(remove, mQueue);
+	snd_seq_remove_events_set_condition(remove, SND_SEQ_REMOVE_OUTPUT | SND_SEQ_REMOVE_IGNORE_OFF);
+	snd_seq_remove_events(mSeq, remove);
+}
+
+// Same enumeration as RtMidi's ALSA backend uses for output port numbers
+bool AlsaSeqScheduler::FindDestination(unsigned int outputPort, int& client, int& port) const
+{
+	const unsigned int caps = SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE;
+	snd_seq_client_info_t* clientInfo;
+	snd_seq_port_info_t* portInfo;
+	snd_seq_client_info_alloca(&clientInfo);
+	snd_seq_port_info_alloca(&portInfo);
+
+	unsigned int count = 0;
+	snd_seq_client_info_set_client(clientInfo, -1);
+	while (snd_seq_query_next_client(mSeq, clientInfo) >= 0)
+	{
+		int candidate = snd_seq_client_info_get_client(clientInfo);
+		if (candidate == 0) continue;
+
+		snd_seq_port_info_set_client(portInfo, candidate);
+		snd_seq_port_info_set_port(portInfo, -1);
+		while (snd_seq_query_next_port(mSeq, portInfo) >= 0)
+		{
+			unsigned int type = snd_seq_port_info_get_type(portInfo);
+			if ((type & (SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_SYNTH | SND_SEQ_PORT_TYPE_APPLICATION)) == 0) continue;
+
+			unsigned int capability = snd_seq_port_info_get_capability(portInfo);
+			if ((capability & caps) != caps || (capability & SND_SEQ_PORT_CAP_NO_EXPORT) != 0) continue;
+
+			if (count++ == outputPort)
+			{
+				client = candidate;
+				port = snd_seq_port_info_get_port(portInfo);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+#else
+
+bool AlsaSeqScheduler::IsSupported()
+{
+	return false;
+}
+
+AlsaSeqScheduler::AlsaSeqScheduler(unsigned int outputPort)
+	: mOutputPort(outputPort)
+{
+}
+
+AlsaSeqScheduler::~AlsaSeqScheduler()
+{
+}
+
+uint64_t AlsaSeqScheduler::GetTimeNs() const
+{
+	return 0;
+}
+
+void AlsaSeqScheduler::Schedule(const MidiMessage&, uint64_t)
+{
+}
+
+void AlsaSeqScheduler::Flush()
+{
+}
+
+void AlsaSeqScheduler::CancelPending()
+{
+}
+
+bool AlsaSeqScheduler::FindDestination(unsigned int, int&, int&) const
+{
+	return false;
+}
+
+#endif
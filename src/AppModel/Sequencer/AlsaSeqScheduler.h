@@ -0,0 +1,65 @@
+// AlsaSeqScheduler.h
+#pragma once
+#include <cstdint>
+#include "RtMidiWrapper/MidiMessage/MidiMessage.h"
+using namespace MidiInterface;
+
+struct _snd_seq;
+struct snd_midi_event;
+
+/// AlsaSeqScheduler queues timestamped MIDI on an ALSA sequencer queue (Linux only).
+///
+/// Responsibilities:
+/// - Open its own sequencer client, port and queue, connected to an output port
+///   (numbered like RtMidi's output ports, so it follows MidiOut::getCurrentPort)
+/// - Schedule messages at a queue time, the kernel delivers them on time
+/// - Cancel everything not yet delivered (except NoteOffs, so nothing gets stuck)
+///
+/// On other platforms, or without a sequencer, IsOpen() is false and the
+/// PlaybackEngine keeps sending immediately.
+///
+/// Usage:
+///   auto scheduler = std::make_shared<AlsaSeqScheduler>(midiOut->getCurrentPort());
+///   scheduler->Schedule(noteOn, scheduler->GetTimeNs() + 20'000'000);
+///   scheduler->Flush();
+class AlsaSeqScheduler
+{
+public:
+	/// Was the ALSA backend compiled in?
+	static bool IsSupported();
+
+	/// Open the client and start the queue (check IsOpen)
+	explicit AlsaSeqScheduler(unsigned int outputPort);
+	~AlsaSeqScheduler();
+
+	AlsaSeqScheduler(const AlsaSeqScheduler&) = delete;
+	AlsaSeqScheduler& operator=(const AlsaSeqScheduler&) = delete;
+
+	/// Did the client open and connect?
+	bool IsOpen() const { return mSeq != nullptr; }
+
+	/// Output port this scheduler is connected to
+	unsigned int GetOutputPort() const { return mOutputPort; }
+
+	/// Current queue time in nanoseconds
+	uint64_t GetTimeNs() const;
+
+	/// Queue a message for delivery at timeNs (a time in the past is delivered right away)
+	void Schedule(const MidiMessage& mm, uint64_t timeNs);
+
+	/// Hand queued messages to the kernel
+	void Flush();
+
+	/// Drop scheduled messages not yet delivered, NoteOffs are kept
+	void CancelPending();
+
+private:
+	_snd_seq* mSeq = nullptr;
+	snd_midi_event* mEncoder = nullptr;
+	int mPort = -1;
+	int mQueue = -1;
+	unsigned int mOutputPort = 0;
+
+	/// Find the client and port of RtMidi's output port number
+	bool FindDestination(unsigned int outputPort, int& client, int& port) const;
+};
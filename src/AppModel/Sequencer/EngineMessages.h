@@ -0,0 +1,79 @@
+// EngineMessages.h
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "AppModel/Transport/Transport.h"
+#include "AppModel/TrackSet/TrackSet.h"
+#include "RtMidiWrapper/RtMidiWrapper.h"
+#include "SpscQueue.h"
+#include "AlsaSeqScheduler.h"
+
+/// Command posted by the GUI thread to the PlaybackEngine.
+/// One struct for every type keeps queue slots reusable; only the fields of the type are read.
+/// Shared data (tracks, tempo map, loop buffer, drum pattern) is immutable once posted.
+struct EngineCommand
+{
+	enum class Type
+	{
+		Start,            // Play from tick, generation
+		Stop,             // Stop and silence all channels
+		Seek,             // Jump to tick while playing, generation
+		SetLoop,          // loop
+		SetTempoMap,      // tempoMap
+		SetMetronome,     // enabled
+		SetChannelMask,   // channelMask: bit per channel that may sound (mute/solo applied)
+		SetTracks,        // tracks
+		SetLoopBuffer,    // events: recording buffer heard during loop recording, null for none
+		SetDrumPattern,   // events: pattern at the ticks of the current loop, null when muted or not looping
+		SetOutput,        // output
+		SetScheduler      // scheduler, lookaheadMs: queue output ahead with timestamps, null sends immediately
+	};
+
+	Type type = Type::Stop;
+	uint64_t tick = 0;
+	uint32_t generation = 0;
+	bool enabled = false;
+	uint16_t channelMask = 0;
+	Transport::LoopSettings loop{};
+	std::shared_ptr<const TempoMap> tempoMap{};
+	std::shared_ptr<const TrackSnapshot> tracks{};
+	std::shared_ptr<const Track> events{};
+	std::shared_ptr<MidiInterface::MidiOut> output{};
+	std::shared_ptr<AlsaSeqScheduler> scheduler{};
+	uint32_t lookaheadMs = 0;
+};
+
+/// Notification posted by the PlaybackEngine to the GUI thread
+struct EngineEvent
+{
+	enum class Type
+	{
+		Position,      // Playhead at tick at steady_clock time clockNs, generation of the Start or Seek it follows
+		LoopWrapped,   // Playback jumped from loop end to loop start
+		Release        // released: data the engine replaced, dropped on the GUI thread
+	};
+
+	Type type = Type::Position;
+	uint64_t tick = 0;
+	uint64_t clockNs = 0;
+	uint32_t generation = 0;
+	std::shared_ptr<const void> released{};
+};
+
+/// Output request from the GUI thread (previews, channel settings, port changes).
+/// The PlaybackEngine owns the port and sends these at the start of its next step.
+struct OutputRequest
+{
+	enum class Type
+	{
+		Send,                  // mm
+		ReleaseSoundingNotes,  // NoteOff for each note sounding on the output
+		ChangePort             // port
+	};
+
+	Type type = Type::Send;
+	MidiInterface::MidiMessage mm{};
+	MidiInterface::ubyte port = 0;
+};
+
+using OutputQueue = SpscQueue<OutputRequest, 1024>;
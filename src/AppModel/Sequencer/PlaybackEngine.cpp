@@ -0,0 +1,429 @@
+// PlaybackEngine.cpp
+#include "PlaybackEngine.h"
+#include <algorithm>
+#include "AppModel/SoundBank/SoundBank.h"
+
+void PlaybackEngine::Step()
+{
+	EngineCommand command;
+	while (mCommands.TryPop(command))
+	{
+		Apply(command);
+	}
+
+	OutputRequest request;
+	while (mOutputRequests.TryPop(request))
+	{
+		Apply(request);
+	}
+
+	if (mPlaying)
+	{
+		Advance();
+	}
+}
+
+void PlaybackEngine::Apply(EngineCommand& command)
+{
+	switch (command.type)
+	{
+	case EngineCommand::Type::Start:
+		if (mPlaying) SilenceAllChannels();
+		mPlaying = true;
+		mGeneration = command.generation;
+		// Reset the step clock, otherwise the first delta is the whole time spent stopped
+		mLastStep = std::chrono::steady_clock::now();
+		SeekTo(command.tick);
+		break;
+
+	case EngineCommand::Type::Stop:
+		mPlaying = false;
+		CancelScheduled();
+		SilenceAllChannels();
+		ReleaseOnGuiThread(std::move(mLoopBuffer));
+		break;
+
+	case EngineCommand::Type::Seek:
+		if (mPlaying) SilenceAllChannels();
+		mGeneration = command.generation;
+		SeekTo(command.tick);
+		break;
+
+	case EngineCommand::Type::SetLoop:
+		mClock.SetLoopSettings(command.loop);
+		Reschedule();
+		break;
+
+	case EngineCommand::Type::SetTempoMap:
+	{
+		std::shared_ptr<const TempoMap> previous = mClock.GetTempoMap();
+		mClock.SetTempoMap(std::move(command.tempoMap));
+		ReleaseOnGuiThread(std::move(previous));
+		Reschedule();
+		break;
+	}
+
+	case EngineCommand::Type::SetMetronome:
+		mMetronomeEnabled = command.enabled;
+		Reschedule();
+		break;
+
+	case EngineCommand::Type::SetChannelMask:
+		mChannelMask = command.channelMask;
+		Reschedule();
+		break;
+
+	case EngineCommand::Type::SetTracks:
+	{
+		std::shared_ptr<const TrackSnapshot> previous = std::move(mTracks);
+		mTracks = std::move(command.tracks);
+		if (mScheduler && mPlaying)
+		{
+			Reschedule();
+		}
+		else if (mTracks)
+		{
+			// Unchanged tracks are shared with the previous snapshot and keep their cursors
+			for (size_t t = 0; t < mTracks->tracks.size(); t++)
+			{
+				if (!previous || previous->tracks[t] != mTracks->tracks[t])
+				{
+					mCursors[t].Seek(*mTracks->tracks[t], mNextTick);
+				}
+			}
+		}
+		ReleaseOnGuiThread(std::move(previous));
+		break;
+	}
+
+	case EngineCommand::Type::SetLoopBuffer:
+		ReleaseOnGuiThread(std::move(mLoopBuffer));
+		mLoopBuffer = std::move(command.events);
+		if (mLoopBuffer)
+		{
+			// Posted right after a wrap: the whole pass plays, a late buffer catches up
+			mLoopCursor.Seek(*mLoopBuffer, mClock.GetLoopStart());
+		}
+		break;
+
+	case EngineCommand::Type::SetDrumPattern:
+		ReleaseOnGuiThread(std::move(mDrumPattern));
+		mDrumPattern = std::move(command.events);
+		if (mDrumPattern)
+		{
+			mDrumCursor.Seek(*mDrumPattern, mNextTick);
+		}
+		Reschedule();
+		break;
+
+	case EngineCommand::Type::SetOutput:
+		ReleaseOnGuiThread(std::move(mOutput));
+		mOutput = std::move(command.output);
+		break;
+
+	case EngineCommand::Type::SetScheduler:
+		CancelScheduled();
+		ReleaseOnGuiThread(std::move(mScheduler));
+		mScheduler = std::move(command.scheduler);
+		mLookaheadNs = static_cast<uint64_t>(command.lookaheadMs) * 1'000'000;
+		if (mScheduler)
+		{
+			Reschedule();
+		}
+		else
+		{
+			// Cursors may have run ahead of the playhead
+			SeekCursors(mClock.GetCurrentTick() + 1);
+		}
+		break;
+	}
+}
+
+void PlaybackEngine::Apply(const OutputRequest& request)
+{
+	if (!mOutput) return;
+
+	switch (request.type)
+	{
+	case OutputRequest::Type::Send:
+		mOutput->sendMessage(request.mm);
+		break;
+
+	case OutputRequest::Type::ReleaseSoundingNotes:
+		mOutput->releaseSoundingNotes();
+		break;
+
+	case OutputRequest::Type::ChangePort:
+		mOutput->changePort(request.port);
+		break;
+	}
+}
+
+void PlaybackEngine::Advance()
+{
+	mClock.UpdatePlayBack(GetDeltaTimeNs());
+	uint64_t currentTick = mClock.GetCurrentTick();
+	const auto loopSettings = mClock.GetLoopSettings();
+
+	if (mClock.ShouldLoopBack(currentTick))
+	{
+		// Scheduled output wrapped its cursors when it queued loop end
+		if (!mScheduler)
+		{
+			// Events before loop end still belong to the pass that just ended
+			CollectThrough(loopSettings.endTick - 1);
+			// The GUI posts the recording buffer of the finished pass after LoopWrapped
+			ReleaseOnGuiThread(std::move(mLoopBuffer));
+			SeekCursors(loopSettings.startTick);
+		}
+
+		mClock.LoopBack();
+		currentTick = mClock.GetCurrentTick();
+		Notify(EngineEvent{EngineEvent::Type::LoopWrapped});
+	}
+
+	if (mScheduler)
+	{
+		ScheduleAhead();
+	}
+	else
+	{
+		CollectThrough(currentTick);
+	}
+
+	// Positions are only UI feedback, keep half the queue for wraps and releases
+	if (mEvents.SizeApprox() < EVENT_CAPACITY / 2)
+	{
+		EngineEvent position{EngineEvent::Type::Position};
+		position.tick = mClock.GetCurrentTick();
+		position.clockNs = static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(mLastStep.time_since_epoch()).count());
+		position.generation = mGeneration;
+		Notify(std::move(position));
+	}
+}
+
+void PlaybackEngine::ScheduleAhead()
+{
+	const auto loopSettings = mClock.GetLoopSettings();
+	const TempoMap& tempoMap = *mClock.GetTempoMap();
+	uint64_t horizonNs = mScheduler->GetTimeNs() + mLookaheadNs;
+
+	for (;;)
+	{
+		uint64_t elapsed = (horizonNs > mAnchorNs) ? (horizonNs - mAnchorNs) * MidiConstants::TICKS_PER_QUARTER : 0;
+		uint64_t horizonTick = tempoMap.GetTick(mAnchorPosition + elapsed - mWrappedPosition);
+
+		if (!loopSettings.enabled || horizonTick < loopSettings.endTick)
+		{
+			CollectThrough(horizonTick);
+			break;
+		}
+
+		// The lookahead reaches loop end: finish this pass, the next one starts when it ends
+		CollectThrough(loopSettings.endTick - 1);
+		mWrappedPosition += tempoMap.GetPosition(loopSettings.endTick) - tempoMap.GetPosition(loopSettings.startTick);
+		ReleaseOnGuiThread(std::move(mLoopBuffer));
+		SeekCursors(loopSettings.startTick);
+	}
+
+	mScheduler->Flush();
+}
+
+void PlaybackEngine::SeekTo(uint64_t tick)
+{
+	mClock.ShiftToTick(tick);
+	SeekCursors(tick);
+
+	if (mScheduler)
+	{
+		CancelScheduled();
+		mAnchorPosition = mClock.GetTempoMap()->GetPosition(tick);
+		mAnchorNs = mScheduler->GetTimeNs();
+		mWrappedPosition = 0;
+	}
+
+	Chase(tick);
+}
+
+void PlaybackEngine::SeekCursors(uint64_t tick)
+{
+	mNextTick = tick;
+
+	if (mTracks)
+	{
+		for (size_t t = 0; t < mTracks->tracks.size(); t++)
+		{
+			mCursors[t].Seek(*mTracks->tracks[t], tick);
+		}
+	}
+	if (mLoopBuffer)
+	{
+		mLoopCursor.Seek(*mLoopBuffer, tick);
+	}
+	if (mDrumPattern)
+	{
+		mDrumCursor.Seek(*mDrumPattern, tick);
+	}
+}
+
+void PlaybackEngine::Chase(uint64_t tick)
+{
+	if (!mTracks || tick == 0) return;
+
+	// One track at a time, all of them at once could outgrow mDue
+	for (size_t t = 0; t < mTracks->tracks.size(); t++)
+	{
+		mTracks->chase[t]->GetStateAt(*mTracks->tracks[t], tick, mChaseState);
+		ChaseIndex::AppendMessages(mChaseState, static_cast<ubyte>(t), tick, mDue);
+		Emit();
+	}
+
+	// The chase is due now and the kernel delivers it as soon as it gets it.
+	// Flushed here, a Reschedule later in this step (SetTracks, SetLoop...) can't cancel it.
+	if (mScheduler) mScheduler->Flush();
+}
+
+void PlaybackEngine::Reschedule()
+{
+	if (!mScheduler || !mPlaying) return;
+
+	// NoteOffs stay queued, notes already sounding still end
+	CancelScheduled();
+	uint64_t currentTick = mClock.GetCurrentTick();
+	mAnchorPosition = mClock.GetTempoMap()->GetPosition(currentTick);
+	mAnchorNs = mScheduler->GetTimeNs();
+	mWrappedPosition = 0;
+	SeekCursors(currentTick + 1);
+}
+
+void PlaybackEngine::CollectThrough(uint64_t toTick)
+{
+	// More beats than mClicks holds or more events than mDue holds (a long stall, a very
+	// fast tempo) are collected in passes, each sent before the next
+	while (mNextTick <= toTick)
+	{
+		uint64_t passEnd = toTick;
+
+		mMerger.Clear();
+		if (mTracks)
+		{
+			for (size_t t = 0; t < mTracks->tracks.size(); t++)
+			{
+				mMerger.AddSource(*mTracks->tracks[t], mCursors[t]);
+			}
+		}
+
+		// During loop recording, also play back what was recorded in previous loop iterations
+		if (mLoopBuffer)
+		{
+			mMerger.AddSource(*mLoopBuffer, mLoopCursor);
+		}
+
+		// Play drum machine pattern during loop playback (the GUI posts none otherwise)
+		if (mDrumPattern)
+		{
+			mMerger.AddSource(*mDrumPattern, mDrumCursor);
+		}
+
+		if (mMetronomeEnabled)
+		{
+			passEnd = CollectClicks(mNextTick, toTick);
+			mClickCursor.Seek(mClicks, 0);
+			mMerger.AddSource(mClicks, mClickCursor);
+		}
+
+		mNextTick = mMerger.CollectDue(passEnd, mDue) + 1;
+		Emit();
+	}
+}
+
+uint64_t PlaybackEngine::CollectClicks(uint64_t fromTick, uint64_t toTick)
+{
+	const TempoMap& tempoMap = *mClock.GetTempoMap();
+
+	mClicks.clear();
+	for (auto beat = tempoMap.GetNextBeat(fromTick); beat.tick <= toTick; beat = tempoMap.GetNextBeat(beat.tick + 1))
+	{
+		// Full: this pass ends at the last click, the next one starts with this beat
+		if (mClicks.size() == CLICK_CAPACITY) return mClicks.back().tick;
+		mClicks.push_back({SoundBank::MetronomeClick(beat.isDownbeat), beat.tick});
+	}
+	return toTick;
+}
+
+void PlaybackEngine::Emit()
+{
+	for (const TimedMidiEvent& event : mDue)
+	{
+		ubyte channel = event.mm.getChannel();
+		if (channel != MidiConstants::METRONOME_CHANNEL && !(mChannelMask & (1u << channel))) continue;
+
+		if (mScheduler)
+		{
+			mScheduler->Schedule(event.mm, GetScheduleTimeNs(event.tick));
+			// The output's state follows, so GUI sends aren't dropped as repeats of stale values
+			if (mOutput) mOutput->recordScheduled(event.mm);
+		}
+		else if (mOutput)
+		{
+			mOutput->sendMessage(event.mm);
+		}
+	}
+	mDue.clear();
+}
+
+uint64_t PlaybackEngine::GetScheduleTimeNs(uint64_t tick) const
+{
+	// Later loop passes count on from the anchor, so passes follow without rounding
+	uint64_t unwrapped = mClock.GetTempoMap()->GetPosition(tick) + mWrappedPosition;
+	if (unwrapped <= mAnchorPosition) return mAnchorNs;
+
+	// Rounded up, nothing plays before its tick
+	uint64_t ticksPerQuarter = MidiConstants::TICKS_PER_QUARTER;
+	return mAnchorNs + (unwrapped - mAnchorPosition + ticksPerQuarter - 1) / ticksPerQuarter;
+}
+
+void PlaybackEngine::CancelScheduled()
+{
+	if (!mScheduler) return;
+
+	mScheduler->CancelPending();
+	mScheduler->Flush();
+	if (mOutput) mOutput->forgetScheduledSettings();
+}
+
+void PlaybackEngine::SilenceAllChannels()
+{
+	if (!mOutput) return;
+
+	if (!mScheduler)
+	{
+		mOutput->releaseSoundingNotes();
+		return;
+	}
+
+	// Scheduled notes go out through the sequencer, the output never saw them
+	for (ubyte c = 0; c < MidiConstants::CHANNEL_COUNT; c++)
+	{
+		mOutput->sendMessage(MidiMessage::AllNotesOff(c));
+	}
+}
+
+uint64_t PlaybackEngine::GetDeltaTimeNs()
+{
+	auto now = std::chrono::steady_clock::now();
+	auto delta = std::chrono::duration_cast<std::chrono::nanoseconds>(now - mLastStep);
+	mLastStep = now;
+	return static_cast<uint64_t>(delta.count());
+}
+
+void PlaybackEngine::ReleaseOnGuiThread(std::shared_ptr<const void> resource)
+{
+	if (!resource) return;
+
+	EngineEvent event{EngineEvent::Type::Release};
+	event.released = std::move(resource);
+	// With the queue full the resource is freed here instead, on the engine thread
+	Notify(std::move(event));
+}
@@ -0,0 +1,153 @@
+// PlaybackEngine.h
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "AppModel/TrackSet/PlaybackCursor.h"
+#include "AppModel/TrackSet/PlaybackMerger.h"
+#include "EngineMessages.h"
+#include "SpscQueue.h"
+
+/// PlaybackEngine sends the MIDI that plays while the transport runs: tracks, the loop
+/// recording buffer, the drum pattern and the metronome.
+///
+/// Responsibilities:
+/// - Advance its own clock by elapsed time every step (sequencer thread, or AppModel::Update)
+/// - Take transport, settings and track changes from the GUI through a wait-free command queue
+/// - Own the output port: GUI sends and port changes arrive through a wait-free output queue
+/// - Report playhead position and loop wraps to the GUI through a wait-free event queue
+/// - Play immutable track snapshots, the GUI keeps editing its TrackSet meanwhile
+/// - With a scheduler, queue everything due within the lookahead on the ALSA sequencer
+///   with timestamps, and cancel and queue again on stop, seek and edits
+/// - On start and seek, chase each track's state at the new playhead from its ChaseIndex
+///
+/// A step reads only what the engine owns and never waits on a lock held by GUI code.
+/// It doesn't allocate either: due events go to a buffer reserved up front and reused,
+/// more than it holds are sent in several passes.
+/// The sources are merged by tick, so events on one tick leave NoteOffs first whatever
+/// source they come from.
+/// Data the engine stops using (old snapshots, patterns, devices) goes back in a Release
+/// event, so the GUI thread frees it.
+///
+/// Usage:
+///   engine.Post(command);                // GUI thread
+///   engine.Step();                       // engine thread, every millisecond
+///   while (engine.PollEvent(event)) {}   // GUI thread
+class PlaybackEngine
+{
+public:
+	static constexpr size_t COMMAND_CAPACITY = 256;
+	static constexpr size_t EVENT_CAPACITY = 1024;
+	static constexpr size_t DUE_CAPACITY = 4096;  // Events one collect pass holds, more are sent in further passes
+	static constexpr size_t CLICK_CAPACITY = 256;  // Metronome clicks rendered per collect pass, mClicks never grows
+	static_assert(DUE_CAPACITY >= ChaseIndex::MAX_MESSAGES, "Chase emits one track at a time, mDue must hold a full track's state");
+
+	PlaybackEngine()
+	{
+		mDue.reserve(DUE_CAPACITY);
+		mClicks.reserve(CLICK_CAPACITY);
+	}
+
+	// GUI Thread
+
+	/// Queue a command for the next step
+	/// @return false if the queue is full, post again on a later update
+	bool Post(EngineCommand command) { return mCommands.TryPush(std::move(command)); }
+
+	/// Take the oldest notification from the engine
+	bool PollEvent(EngineEvent& event) { return mEvents.TryPop(event); }
+
+	/// Queue the GUI pushes output requests to, sent at the start of the next step
+	OutputQueue& GetOutputQueue() { return mOutputRequests; }
+
+	// Engine Thread
+
+	/// Apply queued commands and output requests, then advance the clock and send due messages
+	void Step();
+
+private:
+	SpscQueue<EngineCommand, COMMAND_CAPACITY> mCommands;
+	SpscQueue<EngineEvent, EVENT_CAPACITY> mEvents;
+	OutputQueue mOutputRequests;
+
+	Transport mClock;  // Tempo, loop and beat math for the engine, separate from the GUI's transport
+	std::chrono::steady_clock::time_point mLastStep;
+	bool mPlaying = false;
+	uint32_t mGeneration = 0;  // Of the last Start or Seek, stamped on Position events
+	uint64_t mNextTick = 0;    // First tick not yet collected (ahead of the playhead when scheduling)
+	bool mMetronomeEnabled = false;
+	uint16_t mChannelMask = 0;
+	std::shared_ptr<const TrackSnapshot> mTracks;
+	std::array<PlaybackCursor, MidiConstants::CHANNEL_COUNT> mCursors;
+	std::shared_ptr<const Track> mLoopBuffer;
+	PlaybackCursor mLoopCursor;
+	std::shared_ptr<const Track> mDrumPattern;
+	PlaybackCursor mDrumCursor;
+	Track mClicks;  // Metronome clicks of one collect, reused
+	PlaybackCursor mClickCursor;
+	PlaybackMerger mMerger;
+	std::shared_ptr<MidiInterface::MidiOut> mOutput;
+	std::shared_ptr<AlsaSeqScheduler> mScheduler;  // Null sends immediately
+	uint64_t mLookaheadNs = 0;
+	uint64_t mAnchorPosition = 0;  // Scheduled output: this TempoMap position plays at queue time mAnchorNs
+	uint64_t mAnchorNs = 0;
+	uint64_t mWrappedPosition = 0;  // Loop lengths (as positions) scheduled since the anchor
+	std::vector<TimedMidiEvent> mDue;  // Collected events of one pass, reused
+	ChaseIndex::ChannelState mChaseState;  // Reused by Chase
+
+	/// Apply one command, moving its shared data into the engine
+	void Apply(EngineCommand& command);
+
+	/// Send, release or change port for one GUI output request (dropped without an output)
+	void Apply(const OutputRequest& request);
+
+	/// Advance the clock and send (or schedule) everything that became due
+	void Advance();
+
+	/// Queue everything up to the lookahead horizon on the scheduler, wrapping at loop end
+	void ScheduleAhead();
+
+	/// Jump the clock and every cursor to tick, scheduled output restarts there
+	void SeekTo(uint64_t tick);
+
+	/// Seek every cursor to tick, nothing before it is collected again
+	void SeekCursors(uint64_t tick);
+
+	/// Send what the tracks set up before tick (program, controllers, pitch bend, held notes)
+	void Chase(uint64_t tick);
+
+	/// Scheduled output only: cancel what was queued ahead and queue again from after the playhead
+	void Reschedule();
+
+	/// Collect tracks, loop buffer, drum pattern and metronome from the next tick through toTick,
+	/// merged in (tick, priority) order, and emit them a pass of at most DUE_CAPACITY at a time
+	void CollectThrough(uint64_t toTick);
+
+	/// Render metronome clicks for beats in [fromTick, toTick] into mClicks, at most CLICK_CAPACITY
+	/// @return Last tick the clicks cover, toTick if every beat fit
+	uint64_t CollectClicks(uint64_t fromTick, uint64_t toTick);
+
+	/// Send collected events of channels in the channel mask, or schedule them at their time
+	void Emit();
+
+	/// Queue time of a tick in the pass being scheduled
+	uint64_t GetScheduleTimeNs(uint64_t tick) const;
+
+	/// Drop scheduled messages not yet delivered; the output forgets the program and
+	/// controller values they would have set
+	void CancelScheduled();
+
+	/// Release sounding notes (AllNotesOff on every channel with scheduled output)
+	void SilenceAllChannels();
+
+	/// Get elapsed time since the last call
+	uint64_t GetDeltaTimeNs();
+
+	/// Post a notification to the GUI (dropped if the queue is full)
+	bool Notify(EngineEvent event) { return mEvents.TryPush(std::move(event)); }
+
+	/// Hand data the engine no longer uses to the GUI thread to free
+	void ReleaseOnGuiThread(std::shared_ptr<const void> resource);
+};
@@ -0,0 +1,55 @@
+// SequencerThread.cpp
+#include "SequencerThread.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+void SequencerThread::Start(StepFunction step, std::chrono::microseconds period)
+{
+	Stop();
+
+	mOverruns.store(0, std::memory_order_relaxed);
+	mRunning.store(true, std::memory_order_release);
+	mThread = std::thread(&SequencerThread::Run, this, std::move(step), period);
+}
+
+void SequencerThread::Stop()
+{
+	mRunning.store(false, std::memory_order_release);
+	if (mThread.joinable())
+	{
+		mThread.join();
+	}
+}
+
+void SequencerThread::Run(StepFunction step, std::chrono::microseconds period)
+{
+#ifdef _WIN32
+	// Default Windows timer granularity is ~15 ms, far too coarse for a 1 ms period
+	timeBeginPeriod(1);
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#endif
+
+	auto deadline = std::chrono::steady_clock::now();
+	while (mRunning.load(std::memory_order_acquire))
+	{
+		step();
+
+		deadline += period;
+		auto now = std::chrono::steady_clock::now();
+		if (now >= deadline)
+		{
+			// Overran: count the missed periods and restart the grid from now
+			auto missed = (now - deadline) / period + 1;
+			mOverruns.fetch_add(static_cast<uint64_t>(missed), std::memory_order_relaxed);
+			deadline = now;
+			continue;
+		}
+		std::this_thread::sleep_until(deadline);
+	}
+
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
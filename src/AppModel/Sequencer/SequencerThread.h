@@ -0,0 +1,53 @@
+// SequencerThread.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+/// SequencerThread calls a step function on its own thread at a fixed period.
+///
+/// Responsibilities:
+/// - Wake on absolute steady_clock deadlines (sleep_until), so the period doesn't drift
+/// - After an overrun, skip the missed deadlines instead of running a burst of steps
+/// - Start and stop (joins the thread) from the GUI thread
+///
+/// The step runs on the sequencer thread, so anything it touches must be shared safely
+/// with the GUI (see AppModel::StartSequencerThread).
+///
+/// Usage:
+///   SequencerThread sequencer;
+///   sequencer.Start([&engine]() { engine.Step(); }, std::chrono::microseconds(1000));
+///   sequencer.Stop();
+class SequencerThread
+{
+public:
+	using StepFunction = std::function<void()>;
+
+	SequencerThread() = default;
+	~SequencerThread() { Stop(); }
+
+	SequencerThread(const SequencerThread&) = delete;
+	SequencerThread& operator=(const SequencerThread&) = delete;
+
+	/// Start calling step every period (restarts if already running)
+	void Start(StepFunction step, std::chrono::microseconds period);
+
+	/// Stop the thread and wait for the current step to finish
+	void Stop();
+
+	/// Check if the thread is running
+	bool IsRunning() const { return mRunning.load(std::memory_order_acquire); }
+
+	/// Number of periods skipped because a step overran
+	uint64_t GetOverrunCount() const { return mOverruns.load(std::memory_order_relaxed); }
+
+private:
+	std::thread mThread;
+	std::atomic<bool> mRunning{false};
+	std::atomic<uint64_t> mOverruns{0};
+
+	/// Thread body: step, then sleep until the next deadline
+	void Run(StepFunction step, std::chrono::microseconds period);
+};
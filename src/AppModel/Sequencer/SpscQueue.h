@@ -0,0 +1,62 @@
+// SpscQueue.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/// SpscQueue is a bounded wait-free ring buffer for one producer thread and one consumer thread.
+///
+/// Responsibilities:
+/// - Hand items from the producer to the consumer without locks or allocation
+/// - Fail a push when full instead of blocking (the producer decides to retry or drop)
+///
+/// Slots are reused, so popping moves the item out and leaves an empty (moved-from) value
+/// behind. Items holding shared_ptrs are therefore released by whoever pops them.
+///
+/// Usage:
+///   SpscQueue<EngineCommand, 256> commands;
+///   commands.TryPush(command);            // producer thread
+///   while (commands.TryPop(command)) {}   // consumer thread
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	/// Append an item (producer thread only)
+	/// @return false if the queue is full, the item is not queued
+	bool TryPush(T item)
+	{
+		size_t head = mHead.load(std::memory_order_relaxed);
+		if (head - mTail.load(std::memory_order_acquire) == Capacity) return false;
+
+		mSlots[head & MASK] = std::move(item);
+		mHead.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Take the oldest item (consumer thread only)
+	/// @return false if the queue is empty
+	bool TryPop(T& item)
+	{
+		size_t tail = mTail.load(std::memory_order_relaxed);
+		if (tail == mHead.load(std::memory_order_acquire)) return false;
+
+		item = std::move(mSlots[tail & MASK]);
+		mTail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Number of queued items (exact only on the producer or consumer thread while the other is idle)
+	size_t SizeApprox() const { return mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire); }
+
+	static constexpr size_t GetCapacity() { return Capacity; }
+
+private:
+	static constexpr size_t MASK = Capacity - 1;
+
+	std::array<T, Capacity> mSlots{};
+	alignas(64) std::atomic<size_t> mHead{0};  // Next slot to write, only the producer stores
+	alignas(64) std::atomic<size_t> mTail{0};  // Next slot to read, only the consumer stores
+};
@@ -1,24 +1,33 @@
+// ChannelColors.h
 #pragma once
-#include <wx/colour.h>
+#include <cstdint>
+
+/// RGB color of a channel. Plain bytes, so the model doesn't depend on the GUI toolkit;
+/// panels convert with wxColour(color.red, color.green, color.blue).
+struct ChannelColor
+{
+	uint8_t red = 0;
+	uint8_t green = 0;
+	uint8_t blue = 0;
+};
 
 	// ========== Track Colors ==========
 	// 15 unique colors for MIDI tracks (channel 16 reserved for metronome)
-	const wxColour TRACK_COLORS[15] = {
-		wxColour(255, 100, 100),  // Red
-		wxColour(100, 255, 100),  // Green
-		wxColour(100, 100, 255),  // Blue
-		wxColour(255, 255, 100),  // Yellow
-		wxColour(255, 100, 255),  // Magenta
-		wxColour(100, 255, 255),  // Cyan
-		wxColour(255, 150, 100),  // Orange
-		wxColour(150, 100, 255),  // Purple
-		wxColour(255, 200, 100),  // Light Orange
-		wxColour(100, 255, 200),  // Mint
-		wxColour(200, 100, 255),  // Violet
-		wxColour(255, 100, 200),  // Pink
-		wxColour(200, 255, 100),  // Lime
-		wxColour(100, 200, 255),  // Sky Blue
-		wxColour(255, 255, 200)   // Light Yellow
+	const ChannelColor TRACK_COLORS[15] = {
+		{255, 100, 100},  // Red
+		{100, 255, 100},  // Green
+		{100, 100, 255},  // Blue
+		{255, 255, 100},  // Yellow
+		{255, 100, 255},  // Magenta
+		{100, 255, 255},  // Cyan
+		{255, 150, 100},  // Orange
+		{150, 100, 255},  // Purple
+		{255, 200, 100},  // Light Orange
+		{100, 255, 200},  // Mint
+		{200, 100, 255},  // Violet
+		{255, 100, 200},  // Pink
+		{200, 255, 100},  // Lime
+		{100, 200, 255},  // Sky Blue
+		{255, 255, 200}   // Light Yellow
 	};
 
-
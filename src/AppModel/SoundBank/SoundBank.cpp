@@ -1,7 +1,7 @@
 #include "SoundBank.h"
-#include "ChannelColors.h"
 
-SoundBank::SoundBank()
+SoundBank::SoundBank(std::shared_ptr<MidiOut> device)
+	: mMidiOut(std::move(device))
 {
 	for (ubyte c = 0; c < MidiConstants::CHANNEL_COUNT; c++)
 	{
@@ -12,8 +12,8 @@ SoundBank::SoundBank()
 	// Drum Track at index 9 
 	mChannels[9].programNumber = 0; 
 	mChannels[9].customName = "Ch 10 - Percussion";
-	mMidiOut = std::make_shared<MidiOut>();
 	ApplyChannelSettings();
+	UpdateChannelMasks();
 }
 
 void SoundBank::SetMidiOutDevice(std::shared_ptr<MidiOut> device)
@@ -22,6 +22,43 @@ void SoundBank::SetMidiOutDevice(std::shared_ptr<MidiOut> device)
 	ApplyChannelSettings();
 }
 
+void SoundBank::SendMessage(const MidiMessage& mm)
+{
+	Send(OutputRequest{.type = OutputRequest::Type::Send, .mm = mm});
+}
+
+void SoundBank::SetOutputPort(ubyte port)
+{
+	Send(OutputRequest{.type = OutputRequest::Type::ChangePort, .port = port});
+}
+
+void SoundBank::Send(const OutputRequest& request)
+{
+	if (!mMidiOut) return;
+
+	// The engine sends at its next step; a full queue drops the request rather than block the GUI
+	if (mOutputQueue)
+	{
+		mOutputQueue->TryPush(request);
+		return;
+	}
+
+	switch (request.type)
+	{
+	case OutputRequest::Type::Send:
+		mMidiOut->sendMessage(request.mm);
+		break;
+
+	case OutputRequest::Type::ReleaseSoundingNotes:
+		mMidiOut->releaseSoundingNotes();
+		break;
+
+	case OutputRequest::Type::ChangePort:
+		mMidiOut->changePort(request.port);
+		break;
+	}
+}
+
 void SoundBank::ApplyChannelSettings()
 {
 	if (!mMidiOut) return;
@@ -31,25 +68,49 @@ void SoundBank::ApplyChannelSettings()
 	{
 		auto pc = MidiMessage::ProgramChange(c.programNumber, c.channelNumber);
 		auto vol = MidiMessage::ControlChange(VOLUME, c.volume, c.channelNumber);
-		mMidiOut->sendMessage(pc);
-		mMidiOut->sendMessage(vol);
+		SendMessage(pc);
+		SendMessage(vol);
 	}
 
 	// Also set metronome sound (channel 15/16) - Program 115 = Woodblock
 	auto metronomePc = MidiMessage::ProgramChange(115, MidiConstants::METRONOME_CHANNEL);
-	mMidiOut->sendMessage(metronomePc);
+	SendMessage(metronomePc);
 }
 
-bool SoundBank::SolosFound() const
+void SoundBank::SetChannelMute(ubyte ch, bool mute)
 {
-	for (auto& c : mChannels)
+	mChannels[ch].mute = mute;
+	UpdateChannelMasks();
+}
+
+void SoundBank::SetChannelSolo(ubyte ch, bool solo)
+{
+	mChannels[ch].solo = solo;
+	UpdateChannelMasks();
+}
+
+void SoundBank::SetChannelRecord(ubyte ch, bool record)
+{
+	mChannels[ch].record = record;
+	UpdateChannelMasks();
+}
+
+void SoundBank::UpdateChannelMasks()
+{
+	uint16_t solo = 0, unmuted = 0, record = 0;
+	for (const auto& c : mChannels)
 	{
-		if (c.solo)
-		{
-			return true;
-		}
+		uint16_t bit = static_cast<uint16_t>(1u << c.channelNumber);
+		if (c.solo) solo |= bit;
+		if (!c.mute) unmuted |= bit;
+		if (c.record) record |= bit;
 	}
-	return false;
+
+	// If any channel is solo'd, only solo channels play
+	mSoloMask = solo;
+	mPlayableMask = solo ? solo : unmuted;
+	mLiveMask = solo ? solo : (record & unmuted);
+	mRecordMask = mLiveMask & record;
 }
 
 std::vector<MidiChannel*> SoundBank::GetRecordEnabledChannels()
@@ -80,38 +141,20 @@ std::vector<MidiChannel*> SoundBank::GetSoloChannels()
 
 bool SoundBank::ShouldChannelPlay(const MidiChannel& channel, bool checkRecord) const 
 {
-	if (SolosFound())
-	{
-		// If any channel is solo'd, only solo channels play
-		return channel.solo;
-	}
-	else
-	{
-		// Normal playback: check mute (and optionally record)
-		if (checkRecord)
-		{
-			return channel.record && !channel.mute;
-		}
-		else
-		{
-			return !channel.mute;
-		}
-	}
-	return false;
+	uint16_t mask = checkRecord ? mLiveMask : mPlayableMask;
+	return (mask & (1u << channel.channelNumber)) != 0;
 }
 
 
-void SoundBank::PlayMessages(std::vector<MidiMessage> msgs)
+void SoundBank::PlayMessages(std::span<const MidiMessage> msgs)
 {
-	if (msgs.empty()) return;
+	if (msgs.empty() || !mMidiOut) return;
 	
-	for (auto& mm : msgs)
+	for (const auto& mm : msgs)
 	{
-		ubyte c = mm.getChannel();
-		auto& channel = GetChannel(c);
-		if (ShouldChannelPlay(channel, false))
+		if (mPlayableMask & (1u << mm.getChannel()))
 		{
-			mMidiOut->sendMessage(mm);
+			SendMessage(mm);
 		}
 	}
 }
@@ -119,36 +162,33 @@ void SoundBank::PlayMessages(std::vector<MidiMessage> msgs)
 
 void SoundBank::PlayNote(ubyte pitch, ubyte velocity, ubyte channel)
 {
-	if (!mMidiOut) return;
-	mMidiOut->sendMessage(MidiMessage::NoteOn(pitch, velocity, channel));
+	SendMessage(MidiMessage::NoteOn(pitch, velocity, channel));
 }
 
 void SoundBank::StopNote(ubyte pitch, ubyte channel)
 {
-	if (!mMidiOut) return;
-	mMidiOut->sendMessage(MidiMessage::NoteOff(pitch, channel));
+	SendMessage(MidiMessage::NoteOff(pitch, channel));
 }
 
 void SoundBank::SilenceAllChannels()
 {
-	if (!mMidiOut) return;
-
-	for (ubyte c = 0; c < MidiConstants::CHANNEL_COUNT; c++)
-	{
-		mMidiOut->sendMessage(MidiMessage::AllNotesOff(c));
-	}
+	// The output knows what is sounding, nothing is sent when all is quiet
+	Send(OutputRequest{.type = OutputRequest::Type::ReleaseSoundingNotes});
 }
 
 void SoundBank::PlayMetronomeClick(bool isDownbeat)
 {
-	if (!mMidiOut) return;
+	SendMessage(MetronomeClick(isDownbeat));
+}
 
+MidiMessage SoundBank::MetronomeClick(bool isDownbeat)
+{
 	// Different pitches and velocities for downbeat vs other beats
 	ubyte note = isDownbeat ? 76 : 72;      // High E vs High C
 	ubyte velocity = isDownbeat ? MidiConstants::MAX_MIDI_NOTE : 90;
 
-	// Send note on metronome channel (channel 16)
-	mMidiOut->sendMessage(MidiMessage::NoteOn(note, velocity, MidiConstants::METRONOME_CHANNEL));
+	// Note on metronome channel (channel 16)
+	return MidiMessage::NoteOn(note, velocity, MidiConstants::METRONOME_CHANNEL);
 }
 
 void SoundBank::PlayPreviewNote(ubyte pitch)
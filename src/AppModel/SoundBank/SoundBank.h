@@ -1,12 +1,13 @@
 // SoundBank.h
 #pragma once
-#include <wx/colour.h>
 #include <memory>
 #include <vector>
 #include <span>
 #include <string>
 #include "RtMidiWrapper/RtMidiWrapper.h"
+#include "AppModel/Sequencer/EngineMessages.h"
 #include "MidiConstants.h"
+#include "ChannelColors.h"
 
 using namespace MidiInterface;
 
@@ -15,20 +16,23 @@ struct MidiChannel
 	ubyte channelNumber = 0;
 	ubyte programNumber = 0;
 	ubyte volume = MidiConstants::DEFAULT_VOLUME;
-	bool mute = false;
+	bool mute = false;    // mute, solo, record: set through SoundBank (or call UpdateChannelMasks)
 	bool solo = false;
 	bool record = false;
 	bool minimized = false;
 	std::string customName = "";  // Custom channel name (empty = use default "Channel N")
-	wxColour customColor;  // Custom channel color (initialized in SoundBank constructor)
+	ChannelColor customColor;  // Custom channel color (initialized in SoundBank constructor)
 };
 
 /// SoundBank manages MIDI output and channel state.
 ///
 /// Responsibilities:
 /// - Manage MIDI output device
+/// - Hand sends to the PlaybackEngine's output queue once attached, the GUI never waits on the port
 /// - Track channel settings (program, volume, mute, solo, record)
+/// - Keep bit-per-channel masks of what plays and records, updated when mute/solo/record change
 /// - Provide playback helpers for notes, messages, and metronome
+///   (the output drops repeated program/controller values and silences only sounding notes)
 /// - Handle preview note state for UI feedback
 ///
 /// Usage:
@@ -39,16 +43,30 @@ struct MidiChannel
 class SoundBank
 {
 public:
-	SoundBank();
+	/// Opens the default MIDI output
+	SoundBank() : SoundBank(std::make_shared<MidiOut>()) { }
+
+	/// Use device for output; with null nothing is sent (headless tools)
+	explicit SoundBank(std::shared_ptr<MidiOut> device);
 
 	// MIDI Device
 
 	/// Set the MIDI output device
 	void SetMidiOutDevice(std::shared_ptr<MidiOut> device);
 
-	/// Get the MIDI output device
+	/// Get the MIDI output device (port names; sending goes through SendMessage)
 	std::shared_ptr<MidiOut> GetMidiOutDevice() const { return mMidiOut; }
 
+	/// Hand output to the PlaybackEngine, which owns the port, instead of sending directly.
+	/// Without a queue (headless tools, before the engine exists) messages go straight out.
+	void SetOutputQueue(OutputQueue* queue) { mOutputQueue = queue; }
+
+	/// Send one message to the output
+	void SendMessage(const MidiMessage& mm);
+
+	/// Switch the output port, notes sounding on the old port are released
+	void SetOutputPort(ubyte port);
+
 	// Channel Management
 
 	/// Apply all channel settings (program, volume) to MIDI device
@@ -61,10 +79,31 @@ public:
 	std::span<MidiChannel> GetAllChannels() { return std::span<MidiChannel>(mChannels); }
 
 	/// Get the color for a channel
-	wxColour GetChannelColor(ubyte ch) const { return mChannels[ch].customColor; }
+	ChannelColor GetChannelColor(ubyte ch) const { return mChannels[ch].customColor; }
+
+	/// Set a channel's mute flag
+	void SetChannelMute(ubyte ch, bool mute);
+
+	/// Set a channel's solo flag
+	void SetChannelSolo(ubyte ch, bool solo);
+
+	/// Set a channel's record flag
+	void SetChannelRecord(ubyte ch, bool record);
+
+	/// Recompute the channel masks (after changing mute/solo/record on channels directly)
+	void UpdateChannelMasks();
+
+	/// Bit per channel that plays back (mute and solo applied)
+	uint16_t GetPlayableMask() const { return mPlayableMask; }
+
+	/// Bit per channel that plays live input (record enabled, mute and solo applied)
+	uint16_t GetLiveMask() const { return mLiveMask; }
+
+	/// Bit per channel that records live input (live and record enabled)
+	uint16_t GetRecordMask() const { return mRecordMask; }
 
 	/// Check if any channel has solo enabled
-	bool SolosFound() const;
+	bool SolosFound() const { return mSoloMask != 0; }
 
 	/// Get all channels with record enabled
 	std::vector<MidiChannel*> GetRecordEnabledChannels();
@@ -78,8 +117,8 @@ public:
 
 	// MIDI Playback
 
-	/// Play a vector of MIDI messages (respects mute/solo)
-	void PlayMessages(std::vector<MidiMessage> msgs);
+	/// Play MIDI messages (respects mute/solo)
+	void PlayMessages(std::span<const MidiMessage> msgs);
 
 	/// Play a single note
 	void PlayNote(ubyte pitch, ubyte velocity, ubyte channel);
@@ -87,13 +126,16 @@ public:
 	/// Stop a single note
 	void StopNote(ubyte pitch, ubyte channel);
 
-	/// Send All Notes Off to all channels
+	/// Send NoteOff for every note still sounding on the output
 	void SilenceAllChannels();
 
 	/// Play a metronome click
 	/// @param isDownbeat true for accented downbeat, false for regular beat
 	void PlayMetronomeClick(bool isDownbeat);
 
+	/// Metronome click message (also sent by the PlaybackEngine)
+	static MidiMessage MetronomeClick(bool isDownbeat);
+
 	// Preview Note (for UI keyboard/mouse hover)
 
 	/// Play a preview note on all record-enabled channels
@@ -116,11 +158,19 @@ public:
 
 private:
 	std::shared_ptr<MidiOut> mMidiOut;
+	OutputQueue* mOutputQueue = nullptr;
 	MidiChannel mChannels[MidiConstants::CHANNEL_COUNT];  // CHANNEL_COUNT channels (channel 16 reserved for metronome)
+	uint16_t mSoloMask = 0;
+	uint16_t mPlayableMask = 0;
+	uint16_t mLiveMask = 0;
+	uint16_t mRecordMask = 0;
 
 	// Preview note state
 	ubyte mPreviewVelocity = MidiConstants::DEFAULT_VELOCITY;
 	bool mIsPreviewingNote = false;
 	ubyte mPreviewPitch = 0;
 	std::vector<ubyte> mPreviewChannels;
+
+	/// Queue the request for the engine, or carry it out here without a queue
+	void Send(const OutputRequest& request);
 };
@@ -0,0 +1,148 @@
+// ChaseIndex.cpp
+#include "ChaseIndex.h"
+#include <algorithm>
+
+namespace
+{
+	// Controllers chased ahead of the others, in this order
+	constexpr ubyte BANK_SELECT_MSB = 0;
+	constexpr ubyte BANK_SELECT_LSB = 32;
+	constexpr ubyte DATA_INCREMENT = 96;
+	constexpr ubyte DATA_DECREMENT = 97;
+	constexpr ubyte NRPN_LSB = 98;
+	constexpr ubyte RPN_MSB = 101;
+
+	bool IsBankSelect(int controller) { return controller == BANK_SELECT_MSB || controller == BANK_SELECT_LSB; }
+	bool IsParameterSelect(int controller) { return controller >= NRPN_LSB && controller <= RPN_MSB; }
+}
+
+void ChaseIndex::ChannelState::Apply(const MidiMessage& mm)
+{
+	switch (mm.getEventType())
+	{
+	case NOTE_ON:
+	case NOTE_OFF:
+		heldVelocity[mm.getPitch() & 0x7F] = mm.isNoteOff() ? 0 : mm.getVelocity();
+		break;
+
+	case PROGRAM_CHANGE:
+		program = mm.mData[1];
+		break;
+
+	case PITCH_BEND:
+		pitchBend = static_cast<uint16_t>(mm.mData[1] | (mm.mData[2] << 7));
+		break;
+
+	case CONTROL_CHANGE:
+	{
+		ubyte controller = mm.mData[1];
+		if (controller < CONTROLLERS)
+		{
+			controllers[controller] = mm.mData[2];
+		}
+		else if (controller == RESET_CONTROLLERS)
+		{
+			controllers.fill(UNKNOWN);
+			pitchBend = NO_PITCH_BEND;
+		}
+		else if (controller == ALL_SOUND_OFF || controller >= ALL_NOTES_OFF)
+		{
+			heldVelocity.fill(0);
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+ChaseIndex::ChaseIndex(const Track& track)
+{
+	ChannelState state;
+	for (size_t i = 0; i < track.size(); i++)
+	{
+		// First event of a checkpoint interval: save the state before it
+		uint64_t checkpointTick = track[i].tick / CHECKPOINT_TICKS * CHECKPOINT_TICKS;
+		if (mCheckpoints.empty() || mCheckpoints.back().tick != checkpointTick)
+		{
+			mCheckpoints.push_back({checkpointTick, i, state});
+		}
+		state.Apply(track[i].mm);
+	}
+}
+
+void ChaseIndex::GetStateAt(const Track& track, uint64_t tick, ChannelState& state) const
+{
+	auto next = std::upper_bound(mCheckpoints.begin(), mCheckpoints.end(), tick,
+		[](uint64_t t, const Checkpoint& c) { return t < c.tick; });
+	if (next == mCheckpoints.begin())
+	{
+		state = ChannelState();
+		return;
+	}
+
+	// Intervals after the checkpoint have no events before tick, they would have a checkpoint
+	const Checkpoint& checkpoint = *(next - 1);
+	state = checkpoint.state;
+	size_t i = checkpoint.position;
+	for (; i < track.size() && track[i].tick < tick; i++)
+	{
+		state.Apply(track[i].mm);
+	}
+
+	// A note ending where playback starts would only sound for an instant
+	for (; i < track.size() && track[i].tick == tick && track[i].mm.isNoteOff(); i++)
+	{
+		state.Apply(track[i].mm);
+	}
+}
+
+void ChaseIndex::AppendMessages(const ChannelState& state, ubyte channel, uint64_t tick, std::vector<TimedMidiEvent>& out)
+{
+	const auto& controllers = state.controllers;
+
+	// Bank select, then the program it applies to
+	for (ubyte controller : {BANK_SELECT_MSB, BANK_SELECT_LSB})
+	{
+		if (controllers[controller] != UNKNOWN)
+		{
+			out.push_back({MidiMessage::ControlChange(controller, controllers[controller], channel), tick});
+		}
+	}
+	if (state.program != UNKNOWN)
+	{
+		out.push_back({MidiMessage::ProgramChange(state.program, channel), tick});
+	}
+
+	// Parameter selects before data entry, increments don't leave state to chase
+	for (int controller = NRPN_LSB; controller <= RPN_MSB; controller++)
+	{
+		if (controllers[controller] != UNKNOWN)
+		{
+			out.push_back({MidiMessage::ControlChange(controller, controllers[controller], channel), tick});
+		}
+	}
+	for (int controller = 0; controller < CONTROLLERS; controller++)
+	{
+		if (controllers[controller] == UNKNOWN || IsBankSelect(controller) || IsParameterSelect(controller) ||
+			controller == DATA_INCREMENT || controller == DATA_DECREMENT)
+		{
+			continue;
+		}
+		out.push_back({MidiMessage::ControlChange(controller, controllers[controller], channel), tick});
+	}
+
+	if (state.pitchBend != NO_PITCH_BEND)
+	{
+		out.push_back({MidiMessage(PITCH_BEND | channel, state.pitchBend & 0x7F, state.pitchBend >> 7), tick});
+	}
+
+	for (int pitch = 0; pitch <= MidiConstants::MAX_MIDI_NOTE; pitch++)
+	{
+		if (state.heldVelocity[pitch] != 0)
+		{
+			out.push_back({MidiMessage::NoteOn(pitch, state.heldVelocity[pitch], channel), tick});
+		}
+	}
+}
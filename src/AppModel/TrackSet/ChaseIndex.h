@@ -0,0 +1,68 @@
+// ChaseIndex.h
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Track.h"
+
+/// ChaseIndex recreates the MIDI state a track has set up by any tick, so playback can
+/// start mid-song with the right program, controllers, pitch bend and held notes.
+///
+/// Responsibilities:
+/// - Keep a checkpoint of the channel state every CHECKPOINT_TICKS (only where the track has events)
+/// - Find the state at a tick from the nearest checkpoint, replaying only the events after it
+/// - Turn a state into the few messages that set it up on a device
+///
+/// Built once per track snapshot on the GUI thread and immutable after. Lookups don't
+/// allocate, so the PlaybackEngine chases on its own thread.
+///
+/// Usage:
+///   ChaseIndex chase(track);
+///   chase.GetStateAt(track, seekTick, state);
+///   ChaseIndex::AppendMessages(state, channel, seekTick, out);
+class ChaseIndex
+{
+public:
+	static constexpr uint64_t CHECKPOINT_TICKS = MidiConstants::TICKS_PER_QUARTER * 4 * 4;  // 4 bars of 4/4
+	static constexpr int CONTROLLERS = 120;  // 120 and up are channel mode messages
+	static constexpr ubyte UNKNOWN = 0xFF;
+	static constexpr uint16_t NO_PITCH_BEND = 0xFFFF;
+	static constexpr size_t MAX_MESSAGES = CONTROLLERS + 2 + MidiConstants::MAX_MIDI_NOTE + 1;  // Most AppendMessages adds for one channel
+
+	/// What one channel's events have set up
+	struct ChannelState
+	{
+		ubyte program = UNKNOWN;
+		std::array<ubyte, CONTROLLERS> controllers;
+		uint16_t pitchBend = NO_PITCH_BEND;
+		std::array<ubyte, MidiConstants::MAX_MIDI_NOTE + 1> heldVelocity{};  // 0 = not held
+
+		ChannelState() { controllers.fill(UNKNOWN); }
+
+		/// Update with the next event of the channel
+		void Apply(const MidiMessage& mm);
+	};
+
+	ChaseIndex() = default;
+
+	/// Index a tick-sorted track
+	explicit ChaseIndex(const Track& track);
+
+	/// State at tick: events before tick applied, notes ending at tick not held.
+	/// track must be the track the index was built from.
+	void GetStateAt(const Track& track, uint64_t tick, ChannelState& state) const;
+
+	/// Append the messages that set up state on channel, at tick: bank, program,
+	/// parameter selects, controllers, pitch bend, then held notes
+	static void AppendMessages(const ChannelState& state, ubyte channel, uint64_t tick, std::vector<TimedMidiEvent>& out);
+
+private:
+	struct Checkpoint
+	{
+		uint64_t tick = 0;    // Multiple of CHECKPOINT_TICKS
+		size_t position = 0;  // First event at or after tick
+		ChannelState state;   // Events before position applied
+	};
+
+	std::vector<Checkpoint> mCheckpoints;
+};
@@ -0,0 +1,60 @@
+// CompactTrack.cpp
+#include "CompactTrack.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+CompactTrack::CompactTrack(const Track& track)
+{
+	mEvents.reserve(track.size());
+	for (const TimedMidiEvent& event : track)
+	{
+		PushBack(event);
+	}
+	mEvents.shrink_to_fit();
+	mBlocks.shrink_to_fit();
+}
+
+void CompactTrack::AssignTo(Track& track) const
+{
+	track.clear();
+	track.reserve(mEvents.size());
+	ForEach([&track](const TimedMidiEvent& event) { track.push_back(event); });
+}
+
+void CompactTrack::PushBack(const TimedMidiEvent& event)
+{
+	// Start a new block when the tick can't be expressed as a 32-bit offset from the current base
+	bool fits = !mBlocks.empty() &&
+		event.tick >= mBlocks.back().baseTick &&
+		event.tick - mBlocks.back().baseTick <= std::numeric_limits<uint32_t>::max();
+	if (!fits)
+	{
+		mBlocks.push_back({event.tick, mEvents.size()});
+	}
+
+	mEvents.push_back({
+		static_cast<uint32_t>(event.tick - mBlocks.back().baseTick),
+		event.mm.mData[0],
+		event.mm.mData[1],
+		event.mm.mData[2]
+	});
+}
+
+TimedMidiEvent CompactTrack::GetEvent(size_t index) const
+{
+	// Last block starting at or before index
+	auto block = std::upper_bound(mBlocks.begin(), mBlocks.end(), index,
+		[](size_t i, const Block& b) { return i < b.firstEvent; });
+	return Decode(mEvents[index], std::prev(block)->baseTick);
+}
+
+size_t CompactTrack::GetMemoryBytes() const
+{
+	return mEvents.capacity() * sizeof(Event) + mBlocks.capacity() * sizeof(Block);
+}
+
+TimedMidiEvent CompactTrack::Decode(const Event& event, uint64_t baseTick)
+{
+	return {MidiMessage(event.status, event.data1, event.data2), baseTick + event.tickOffset};
+}
@@ -0,0 +1,83 @@
+// CompactTrack.h
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Track.h"
+
+/// CompactTrack stores events in 8 bytes each for long-lived copies (undo history, snapshots).
+///
+/// Each event keeps a 32-bit tick offset from the base tick of the block it belongs to,
+/// plus the status and two data bytes. A new block starts whenever an event's tick does
+/// not fit the current block (earlier than its base or more than 2^32 ticks after it),
+/// so tick order is not required and most tracks need a single block.
+/// The MidiMessage timestamp is not stored.
+///
+/// Responsibilities:
+/// - Convert to and from Track
+/// - Sequential and indexed access to decoded events
+/// - Report its memory footprint
+///
+/// Usage:
+///   CompactTrack backup(track);
+///   backup.AssignTo(track);  // restore
+class CompactTrack
+{
+public:
+	CompactTrack() = default;
+
+	/// Encode a Track
+	explicit CompactTrack(const Track& track);
+
+	/// Overwrite a Track with the decoded events, reusing its capacity
+	void AssignTo(Track& track) const;
+
+	/// Decode to a new Track
+	Track ToTrack() const { Track track; AssignTo(track); return track; }
+
+	size_t size() const { return mEvents.size(); }
+	bool empty() const { return mEvents.empty(); }
+
+	/// Append an event
+	void PushBack(const TimedMidiEvent& event);
+
+	/// Decode one event (O(log blocks))
+	TimedMidiEvent GetEvent(size_t index) const;
+
+	/// Call fn(const TimedMidiEvent&) for every event in order
+	template <typename Fn>
+	void ForEach(Fn&& fn) const
+	{
+		size_t block = 0;
+		for (size_t i = 0; i < mEvents.size(); i++)
+		{
+			while (block + 1 < mBlocks.size() && mBlocks[block + 1].firstEvent <= i) block++;
+			fn(Decode(mEvents[i], mBlocks[block].baseTick));
+		}
+	}
+
+	/// Heap bytes held (capacity, not size)
+	size_t GetMemoryBytes() const;
+
+private:
+	struct Event
+	{
+		uint32_t tickOffset;  // Tick relative to the block's base tick
+		ubyte status;
+		ubyte data1;
+		ubyte data2;
+		ubyte reserved = 0;
+	};
+	static_assert(sizeof(Event) == 8, "CompactTrack events must stay 8 bytes");
+
+	struct Block
+	{
+		uint64_t baseTick;
+		size_t firstEvent;  // Index of the first event encoded against baseTick
+	};
+
+	std::vector<Event> mEvents;
+	std::vector<Block> mBlocks;
+
+	static TimedMidiEvent Decode(const Event& event, uint64_t baseTick);
+};
@@ -0,0 +1,76 @@
+// NoteIntervalIndex.cpp
+#include "NoteIntervalIndex.h"
+#include <algorithm>
+
+void NoteIntervalIndex::Build(const std::vector<NoteLocation>& notes)
+{
+	// Count notes per pitch, then turn counts into lane offsets
+	std::array<uint32_t, LANE_COUNT + 1> counts{};
+	for (const NoteLocation& note : notes)
+	{
+		counts[(note.pitch & 0x7F) + 1]++;
+	}
+	for (int p = 0; p < LANE_COUNT; p++)
+	{
+		counts[p + 1] += counts[p];
+	}
+	mLaneOffsets = counts;
+
+	mStartTicks.resize(notes.size());
+	mEndTicks.resize(notes.size());
+	mNotePositions.resize(notes.size());
+
+	// Stable counting sort by pitch keeps each lane in start tick order
+	std::array<uint32_t, LANE_COUNT + 1> next = mLaneOffsets;
+	for (uint32_t i = 0; i < notes.size(); i++)
+	{
+		uint32_t slot = next[notes[i].pitch & 0x7F]++;
+		mStartTicks[slot] = notes[i].startTick;
+		mEndTicks[slot] = notes[i].endTick;
+		mNotePositions[slot] = i;
+	}
+
+	// Lanes sit next to each other, one tree over all of them
+	mLeafCount = 1;
+	while (mLeafCount < notes.size()) mLeafCount *= 2;
+	mMaxEndTree.assign(mLeafCount * 2, 0);
+	std::copy(mEndTicks.begin(), mEndTicks.end(), mMaxEndTree.begin() + mLeafCount);
+	for (size_t node = mLeafCount - 1; node > 0; node--)
+	{
+		mMaxEndTree[node] = std::max(mMaxEndTree[node * 2], mMaxEndTree[node * 2 + 1]);
+	}
+}
+
+void NoteIntervalIndex::Query(uint64_t minTick, uint64_t maxTick, ubyte minPitch, ubyte maxPitch, std::vector<uint32_t>& out) const
+{
+	int lastPitch = std::min<int>(maxPitch, LANE_COUNT - 1);
+
+	for (int p = minPitch; p <= lastPitch; p++)
+	{
+		size_t laneBegin = mLaneOffsets[p];
+		if (laneBegin == mLaneOffsets[p + 1]) continue;
+
+		// Notes from this point on start after maxTick
+		size_t laneEnd = std::upper_bound(mStartTicks.begin() + laneBegin, mStartTicks.begin() + mLaneOffsets[p + 1], maxTick)
+			- mStartTicks.begin();
+
+		CollectEndingFrom(1, 0, mLeafCount, laneBegin, laneEnd, minTick, out);
+	}
+}
+
+void NoteIntervalIndex::CollectEndingFrom(size_t node, size_t nodeLo, size_t nodeHi, size_t lo, size_t hi,
+	uint64_t minTick, std::vector<uint32_t>& out) const
+{
+	if (hi <= nodeLo || nodeHi <= lo || mMaxEndTree[node] < minTick) return;
+
+	if (nodeHi - nodeLo == 1)
+	{
+		out.push_back(mNotePositions[nodeLo]);
+		return;
+	}
+
+	// Left first, so hits stay in start tick order
+	size_t middle = (nodeLo + nodeHi) / 2;
+	CollectEndingFrom(node * 2, nodeLo, middle, lo, hi, minTick, out);
+	CollectEndingFrom(node * 2 + 1, middle, nodeHi, lo, hi, minTick, out);
+}
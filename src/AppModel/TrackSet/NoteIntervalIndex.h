@@ -0,0 +1,50 @@
+// NoteIntervalIndex.h
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "MidiConstants.h"
+#include "NoteTypes.h"
+
+/// NoteIntervalIndex answers tick/pitch region queries over one track's notes in O((k + 1) log n).
+///
+/// Responsibilities:
+/// - Bucket notes by pitch into lanes ordered by start tick
+/// - Keep a max-end segment tree over the lanes: a binary search bounds the notes starting
+///   by the range end, and subtrees ending before the range start are skipped whole
+///
+/// A long note (pedal, drone) only costs its own hit, it doesn't make later queries
+/// scan the notes after it.
+///
+/// Notes are stored as positions into the note list the index was built from,
+/// so the index must be rebuilt whenever that list changes.
+///
+/// Usage:
+///   NoteIntervalIndex index;
+///   index.Build(trackNotes);  // trackNotes ordered by start tick
+///   std::vector<uint32_t> hits;
+///   index.Query(minTick, maxTick, minPitch, maxPitch, hits);
+class NoteIntervalIndex
+{
+public:
+	/// Rebuild the lanes from a note list ordered by start tick
+	void Build(const std::vector<NoteLocation>& notes);
+
+	/// Append positions of notes overlapping the region (bounds inclusive)
+	/// @param out Receives positions in the note list passed to Build, per pitch in start tick order
+	void Query(uint64_t minTick, uint64_t maxTick, ubyte minPitch, ubyte maxPitch, std::vector<uint32_t>& out) const;
+
+private:
+	static constexpr int LANE_COUNT = MidiConstants::MIDI_NOTE_COUNT;
+
+	std::array<uint32_t, LANE_COUNT + 1> mLaneOffsets{};  // Lane p spans [mLaneOffsets[p], mLaneOffsets[p + 1])
+	std::vector<uint64_t> mStartTicks;
+	std::vector<uint64_t> mEndTicks;
+	std::vector<uint32_t> mNotePositions;
+	std::vector<uint64_t> mMaxEndTree;  // Segment tree of max end tick, leaf i at mLeafCount + i
+	size_t mLeafCount = 0;              // Power of two >= note count
+
+	/// Append positions of notes in [lo, hi) of node's span [nodeLo, nodeHi) that end at or after minTick
+	void CollectEndingFrom(size_t node, size_t nodeLo, size_t nodeHi, size_t lo, size_t hi,
+		uint64_t minTick, std::vector<uint32_t>& out) const;
+};
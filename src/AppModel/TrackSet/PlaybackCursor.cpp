@@ -0,0 +1,43 @@
+// PlaybackCursor.cpp
+#include "PlaybackCursor.h"
+#include <algorithm>
+
+void PlaybackCursor::Seek(const Track& track, uint64_t startTick)
+{
+	// Loop wrap seeks the same tick every iteration, reuse the last result while the track allows it
+	if (mHasAnchor && mAnchorTick == startTick && IsSeekPosition(track, mAnchorPosition, startTick))
+	{
+		mPosition = mAnchorPosition;
+		return;
+	}
+
+	auto it = std::lower_bound(track.begin(), track.end(), startTick,
+		[](const TimedMidiEvent& event, uint64_t tick) { return event.tick < tick; });
+	mPosition = static_cast<size_t>(it - track.begin());
+
+	mAnchorTick = startTick;
+	mAnchorPosition = mPosition;
+	mHasAnchor = true;
+}
+
+const TimedMidiEvent* PlaybackCursor::PeekDue(const Track& track, uint64_t currentTick) const
+{
+	if (mPosition >= track.size() || track[mPosition].tick > currentTick) return nullptr;
+	return &track[mPosition];
+}
+
+void PlaybackCursor::Rewind(const Track& track, uint64_t tick)
+{
+	while (mPosition > 0 && mPosition <= track.size() && track[mPosition - 1].tick >= tick)
+	{
+		mPosition--;
+	}
+}
+
+bool PlaybackCursor::IsSeekPosition(const Track& track, size_t position, uint64_t tick)
+{
+	if (position > track.size()) return false;
+	bool previousIsBefore = (position == 0 || track[position - 1].tick < tick);
+	bool currentIsAtOrAfter = (position == track.size() || track[position].tick >= tick);
+	return previousIsBefore && currentIsAtOrAfter;
+}
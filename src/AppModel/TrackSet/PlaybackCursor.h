@@ -0,0 +1,48 @@
+// PlaybackCursor.h
+#pragma once
+#include <cstddef>
+#include "Track.h"
+
+/// PlaybackCursor walks a tick-sorted track during playback.
+///
+/// Responsibilities:
+/// - Seek to the first event at or after a tick by binary search
+/// - Remember the last seek target, so repeated seeks to the same tick
+///   (loop wrap) are validated in O(1) instead of searched again
+/// - Show the next event once it is due, and step past it (or back over a partly taken tick)
+///
+/// The cursor stores a position, not an iterator, so it survives reallocation
+/// of the track. Edits before the cursor shift what it points at, as with any index.
+///
+/// Usage:
+///   PlaybackCursor cursor;
+///   cursor.Seek(track, loopStartTick);
+///   while (const TimedMidiEvent* event = cursor.PeekDue(track, currentTick))
+///   {
+///       out.push_back(*event);
+///       cursor.Advance();
+///   }
+class PlaybackCursor
+{
+public:
+	/// Position the cursor on the first event with tick >= startTick
+	void Seek(const Track& track, uint64_t startTick);
+
+	/// Next event if it is at or before currentTick, otherwise null (the cursor doesn't move)
+	const TimedMidiEvent* PeekDue(const Track& track, uint64_t currentTick) const;
+
+	/// Move past the event PeekDue returned
+	void Advance() { mPosition++; }
+
+	/// Step back over events already passed at or after tick, the seek anchor is kept
+	void Rewind(const Track& track, uint64_t tick);
+
+private:
+	size_t mPosition = 0;
+	uint64_t mAnchorTick = 0;     // Last seek target and where it landed
+	size_t mAnchorPosition = 0;
+	bool mHasAnchor = false;
+
+	/// Is position the first event at or after tick? (O(1) check of both neighbours)
+	static bool IsSeekPosition(const Track& track, size_t position, uint64_t tick);
+};
@@ -0,0 +1,66 @@
+// PlaybackMerger.cpp
+#include "PlaybackMerger.h"
+#include <algorithm>
+
+void PlaybackMerger::AddSource(const Track& track, PlaybackCursor& cursor)
+{
+	if (mSourceCount == MAX_SOURCES) return;
+	mSources[mSourceCount++] = Source{&track, &cursor};
+}
+
+uint64_t PlaybackMerger::CollectDue(uint64_t currentTick, std::vector<TimedMidiEvent>& out)
+{
+	size_t heapSize = 0;
+	for (size_t s = 0; s < mSourceCount; s++)
+	{
+		PushHead(static_cast<uint8_t>(s), currentTick, heapSize);
+	}
+
+	const size_t begin = out.size();
+	size_t tickBegin = begin;  // Where the events of the tick being merged start in out
+	uint64_t tick = 0;
+	while (heapSize > 0)
+	{
+		std::pop_heap(mHeap.begin(), mHeap.begin() + heapSize, Later);
+		const Head head = mHeap[--heapSize];
+		if (head.tick != tick)
+		{
+			tick = head.tick;
+			tickBegin = out.size();
+		}
+
+		// Full: take back what this tick already appended, the next collect starts with it
+		if (out.size() == out.capacity() && tickBegin > begin)
+		{
+			out.erase(out.begin() + static_cast<std::ptrdiff_t>(tickBegin), out.end());
+			for (size_t s = 0; s < mSourceCount; s++)
+			{
+				mSources[s].cursor->Rewind(*mSources[s].track, tick);
+			}
+			return tick - 1;
+		}
+
+		uint8_t source = head.source;
+		PlaybackCursor& cursor = *mSources[source].cursor;
+		out.push_back(*cursor.PeekDue(*mSources[source].track, currentTick));
+		cursor.Advance();
+		PushHead(source, currentTick, heapSize);
+	}
+	return currentTick;
+}
+
+void PlaybackMerger::PushHead(uint8_t source, uint64_t currentTick, size_t& heapSize)
+{
+	const TimedMidiEvent* event = mSources[source].cursor->PeekDue(*mSources[source].track, currentTick);
+	if (!event) return;
+
+	mHeap[heapSize++] = Head{event->tick, static_cast<uint8_t>(event->mm.isNoteOff() ? 0 : 1), source};
+	std::push_heap(mHeap.begin(), mHeap.begin() + heapSize, Later);
+}
+
+bool PlaybackMerger::Later(const Head& a, const Head& b)
+{
+	if (a.tick != b.tick) return a.tick > b.tick;
+	if (a.priority != b.priority) return a.priority > b.priority;
+	return a.source > b.source;
+}
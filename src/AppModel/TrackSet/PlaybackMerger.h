@@ -0,0 +1,67 @@
+// PlaybackMerger.h
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "PlaybackCursor.h"
+#include "Track.h"
+
+/// PlaybackMerger combines the events due from several tick-sorted sources into one
+/// stream in (tick, priority) order, so a step's output no longer depends on which
+/// source an event came from.
+///
+/// Responsibilities:
+/// - Hold the sources of one collect: a track and the cursor walking it
+/// - Merge their due events through a min-heap keyed on (tick, priority, source)
+/// - Advance each cursor past what it took
+///
+/// Priority follows track order: a NoteOff goes before other events on its tick, so a
+/// note ending where another source starts the same pitch is released first. Equal keys
+/// keep the order the sources were added in. The heap lives in fixed arrays, and a merge
+/// stops at a tick boundary once out's reserved capacity is used, so it doesn't grow out
+/// (only a single tick due with more events than out holds is collected whole anyway).
+///
+/// Usage:
+///   merger.Clear();
+///   merger.AddSource(track, cursor);
+///   merger.CollectDue(currentTick, out);
+class PlaybackMerger
+{
+public:
+	static constexpr size_t MAX_SOURCES = MidiConstants::CHANNEL_COUNT + 3;  // Tracks, loop buffer, drum pattern, metronome
+
+	/// Drop all sources
+	void Clear() { mSourceCount = 0; }
+
+	/// Add a source, ties on (tick, priority) go to earlier sources. Ignored once MAX_SOURCES are added.
+	void AddSource(const Track& track, PlaybackCursor& cursor);
+
+	/// Append the events at or before currentTick from all sources, in order, at most
+	/// out.capacity() - out.size() of them. Cursors stop after the last tick appended.
+	/// @return Last tick collected in full: currentTick, or earlier when out is full
+	uint64_t CollectDue(uint64_t currentTick, std::vector<TimedMidiEvent>& out);
+
+private:
+	struct Source
+	{
+		const Track* track = nullptr;
+		PlaybackCursor* cursor = nullptr;
+	};
+
+	struct Head
+	{
+		uint64_t tick = 0;
+		uint8_t priority = 0;
+		uint8_t source = 0;
+	};
+
+	std::array<Source, MAX_SOURCES> mSources;
+	size_t mSourceCount = 0;
+	std::array<Head, MAX_SOURCES> mHeap;
+
+	/// Push the next due event of a source onto the heap, if it has one
+	void PushHead(uint8_t source, uint64_t currentTick, size_t& heapSize);
+
+	/// Heap order, the smallest key on top
+	static bool Later(const Head& a, const Head& b);
+};
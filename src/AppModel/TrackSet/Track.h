@@ -0,0 +1,18 @@
+// Track.h
+// Timed MIDI event and track container types shared by TrackSet and its helpers
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "RtMidiWrapper/MidiMessage/MidiMessage.h"
+#include "MidiConstants.h"
+using namespace MidiInterface;
+
+struct TimedMidiEvent
+{
+	MidiMessage mm;
+	uint64_t	tick = 0;
+};
+
+using Track = std::vector<TimedMidiEvent>;
+using TrackBank = std::array<Track, MidiConstants::CHANNEL_COUNT>;  // CHANNEL_COUNT tracks (channel 16 reserved for metronome)
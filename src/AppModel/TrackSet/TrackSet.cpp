@@ -1,80 +1,77 @@
 // TrackSet.cpp
 #include "TrackSet.h"
-#include <set>
+#include "CompactTrack.h"
+#include <tuple>
+#include <unordered_set>
 
 bool TrackSet::IsEmpty() const
 {
-	auto notes = GetAllNotes();
-	return notes.empty();
-}
-
-std::vector<MidiMessage> TrackSet::PlayBack(uint64_t currentTick)
-{
-	std::vector<MidiMessage> scheduledMessages;
-
-	for (int t = 0; t < MidiConstants::CHANNEL_COUNT; t++)
+	for (int trackIndex = 0; trackIndex < MidiConstants::CHANNEL_COUNT; trackIndex++)
 	{
-		// Track is empty or at the end
-		if (iterators[t] == -1) continue;
-
-		auto& track = GetTrack(t);
-
-		// Process all events at or before currentTick
-		while (iterators[t] != -1 &&
-			iterators[t] < track.size() &&
-			track[iterators[t]].tick <= currentTick)
-		{
-			scheduledMessages.push_back(track[iterators[t]].mm);
-			iterators[t]++;
-			if (iterators[t] >= track.size())
-			{
-				iterators[t] = -1;
-				break;
-			}
-		}
+		if (!GetNoteIndex(trackIndex).empty()) return false;
 	}
-	return scheduledMessages;
+	return true;
 }
 
-void TrackSet::FindStart(uint64_t startTick)
+std::shared_ptr<const TrackSnapshot> TrackSet::GetSnapshot() const
 {
-	// we want to avoid TrackSet::messages with timestamp < startTick
+	if (mSnapshot && mSnapshotVersions == mTrackVersions) return mSnapshot;
+
+	auto snapshot = std::make_shared<TrackSnapshot>();
 	for (int t = 0; t < MidiConstants::CHANNEL_COUNT; t++)
 	{
-		auto& track = GetTrack(t);
-		if (track.empty())
+		if (mSnapshot && mSnapshotVersions[t] == mTrackVersions[t])
 		{
-			iterators[t] = -1;
-			continue;
+			snapshot->tracks[t] = mSnapshot->tracks[t];
+			snapshot->chase[t] = mSnapshot->chase[t];
 		}
-		int i = 0;
-		while (i < track.size() && track[i].tick < startTick)
+		else
 		{
-			i++;
+			snapshot->tracks[t] = std::make_shared<const Track>(mTracks[t]);
+			snapshot->chase[t] = std::make_shared<const ChaseIndex>(*snapshot->tracks[t]);
 		}
-		iterators[t] = (i < track.size()) ? i : -1;
 	}
+	mSnapshot = std::move(snapshot);
+	mSnapshotVersions = mTrackVersions;
+	return mSnapshot;
 }
 
 NoteLocation TrackSet::FindNoteAt(uint64_t tick, ubyte pitch) const
 {
-	auto allNotes = GetAllNotes();
-	for (const NoteLocation& note : allNotes)
+	std::vector<NoteLocation> hits;
+	for (int trackIndex = 0; trackIndex < MidiConstants::CHANNEL_COUNT; trackIndex++)
 	{
-		if (note.pitch == pitch && tick >= note.startTick && tick <= note.endTick)
+		QueryTrack(trackIndex, tick, tick, pitch, pitch, hits);
+		if (!hits.empty())
 		{
-			return note;
+			return hits.front();
 		}
 	}
 	return NoteLocation{}; // Note not found
 }
 
+NoteLocation TrackSet::FindNoteById(NoteId id) const
+{
+	auto slot = mNoteSlots.find(id);
+	if (slot == mNoteSlots.end()) return NoteLocation{};
+
+	int trackIndex = slot->second.trackIndex;
+	if (mNoteIndexDirty[trackIndex])
+	{
+		// The rebuild carries the id to the note's new position, or drops it
+		GetNoteIndex(trackIndex);
+		slot = mNoteSlots.find(id);
+		if (slot == mNoteSlots.end()) return NoteLocation{};
+	}
+	return mNoteIndex[trackIndex][slot->second.position];
+}
+
 NoteLocation TrackSet::FindNoteInTrack(int trackIndex, uint64_t startTick, uint64_t endTick, ubyte pitch) const
 {
-	const Track& track = mTracks[trackIndex];
-	auto trackNotes = GetNotesFromTrack(track, trackIndex);
+	std::vector<NoteLocation> candidates;
+	QueryTrack(trackIndex, startTick, startTick, pitch, pitch, candidates);
 
-	for (const NoteLocation& note : trackNotes)
+	for (const NoteLocation& note : candidates)
 	{
 		if (note.pitch == pitch && note.startTick == startTick && note.endTick == endTick)
 		{
@@ -84,33 +81,46 @@ NoteLocation TrackSet::FindNoteInTrack(int trackIndex, uint64_t startTick, uint6
 	return NoteLocation{}; // Note not found
 }
 
-std::vector<NoteLocation> TrackSet::FindNotesInRegion(
-	uint64_t minTick, uint64_t maxTick, ubyte minPitch, ubyte maxPitch, int trackIndex) const
+NoteLocation TrackSet::ResolveNote(const NoteLocation& note) const
 {
-	std::vector<NoteLocation> allNotes;
+	if (!note.found || note.trackIndex < 0 || note.trackIndex >= MidiConstants::CHANNEL_COUNT)
+		return NoteLocation{};
 
-	// If trackIndex specified, only search that track. Otherwise search all tracks.
-	if (trackIndex >= 0 && trackIndex < MidiConstants::CHANNEL_COUNT)
+	if (note.id != 0)
 	{
-		allNotes = GetNotesFromTrack(mTracks[trackIndex], trackIndex);
+		NoteLocation byId = FindNoteById(note.id);
+		if (byId.found) return byId;
 	}
-	else
+
+	// Fast path: indices still point at the expected NoteOn/NoteOff pair
+	const Track& track = mTracks[note.trackIndex];
+	if (note.noteOnIndex < note.noteOffIndex && note.noteOffIndex < track.size())
 	{
-		allNotes = GetAllNotes();
+		const TimedMidiEvent& noteOn = track[note.noteOnIndex];
+		const TimedMidiEvent& noteOff = track[note.noteOffIndex];
+		if (noteOn.tick == note.startTick && noteOn.mm.isNoteOn() && noteOn.mm.getPitch() == note.pitch &&
+			noteOff.tick == note.endTick && noteOff.mm.isNoteOff() && noteOff.mm.getPitch() == note.pitch)
+		{
+			return note;
+		}
 	}
 
+	return FindNoteInTrack(note.trackIndex, note.startTick, note.endTick, note.pitch);
+}
+
+std::vector<NoteLocation> TrackSet::FindNotesInRegion(
+	uint64_t minTick, uint64_t maxTick, ubyte minPitch, ubyte maxPitch, int trackIndex) const
+{
 	std::vector<NoteLocation> result;
 
-	for (const NoteLocation& note : allNotes)
-	{
-		// Check if note overlaps region
-		bool pitchInRange = (note.pitch >= minPitch && note.pitch <= maxPitch);
-		bool timeOverlaps = (note.startTick <= maxTick && note.endTick >= minTick);
+	// If trackIndex specified, only search that track. Otherwise search all tracks.
+	bool singleTrack = (trackIndex >= 0 && trackIndex < MidiConstants::CHANNEL_COUNT);
+	int firstTrack = singleTrack ? trackIndex : 0;
+	int lastTrack = singleTrack ? trackIndex : MidiConstants::CHANNEL_COUNT - 1;
 
-		if (pitchInRange && timeOverlaps)
-		{
-			result.push_back(note);
-		}
+	for (int t = firstTrack; t <= lastTrack; t++)
+	{
+		QueryTrack(t, minTick, maxTick, minPitch, maxPitch, result);
 	}
 	return result;
 }
@@ -121,8 +131,7 @@ std::vector<NoteLocation> TrackSet::GetAllNotes() const
 
 	for (int trackIndex = 0; trackIndex < MidiConstants::CHANNEL_COUNT; trackIndex++)
 	{
-		const Track& track = mTracks[trackIndex];
-		std::vector<NoteLocation> trackNotes = GetNotesFromTrack(track, trackIndex);
+		const NoteIndex& trackNotes = GetNoteIndex(trackIndex);
 		result.insert(result.end(), trackNotes.begin(), trackNotes.end());
 	}
 
@@ -142,40 +151,351 @@ std::vector<TimedMidiEvent> TrackSet::GetAllTimedMidiEvents()
 	return result;
 }
 
+NoteLocation TrackSet::AddNote(int trackIndex, const TimedMidiEvent& noteOn, const TimedMidiEvent& noteOff, NoteId id)
+{
+	Track& track = mTracks[trackIndex];
+	ubyte pitch = noteOn.mm.getPitch();
+	MarkTrackChanged(trackIndex);
+
+	// Never hand out an id that still belongs to another note
+	if (mNoteSlots.count(id) > 0) id = 0;
+
+	// Overlapping same-pitch notes or unpaired NoteOns can change how existing
+	// pairs match up, rebuild the index instead of patching it. So can a note that
+	// doesn't end after it starts: its NoteOff sorts ahead of its NoteOn.
+	bool rebuild = mNoteIndexDirty[trackIndex] || mUnpairedNoteOns[trackIndex] > 0 ||
+		noteOff.tick <= noteOn.tick || OverlapsIndexedNote(trackIndex, noteOn.tick, noteOff.tick, pitch);
+
+	size_t noteOnIndex = InsertSorted(track, noteOn);
+	size_t noteOffIndex = InsertSorted(track, noteOff);
+	if (noteOffIndex <= noteOnIndex) noteOnIndex++;  // The NoteOff went in ahead of it
+
+	for (size_t i = noteOnIndex + 1; i < noteOffIndex && !rebuild; i++)
+	{
+		const MidiMessage& mm = track[i].mm;
+		rebuild = (mm.isNoteOn() || mm.isNoteOff()) && mm.getPitch() == pitch;
+	}
+
+	if (rebuild)
+	{
+		if (id != 0)
+		{
+			NoteLocation pending;
+			pending.id = id;
+			pending.startTick = noteOn.tick;
+			pending.endTick = noteOff.tick;
+			pending.pitch = pitch;
+			mPendingIds[trackIndex].push_back(pending);
+		}
+		InvalidateNoteIndex(trackIndex);
+		GetNoteIndex(trackIndex);
+
+		NoteIndex& index = mNoteIndex[trackIndex];
+		for (size_t position = 0; position < index.size(); position++)
+		{
+			if (index[position].noteOnIndex != noteOnIndex) continue;
+
+			// An identical note may have claimed the requested id, swap so the inserted note gets it
+			auto twin = mNoteSlots.find(id);
+			if (twin != mNoteSlots.end() && twin->second.trackIndex == trackIndex && twin->second.position != position)
+			{
+				size_t twinPosition = twin->second.position;
+				std::swap(index[position].id, index[twinPosition].id);
+				mNoteSlots[index[position].id].position = position;
+				mNoteSlots[index[twinPosition].id].position = twinPosition;
+			}
+			return index[position];
+		}
+		return NoteLocation{};
+	}
+
+	// Shift the indices of every event that moved to make room
+	NoteIndex& index = mNoteIndex[trackIndex];
+	for (NoteLocation& note : index)
+	{
+		if (note.noteOnIndex >= noteOnIndex) note.noteOnIndex++;
+		if (note.noteOffIndex >= noteOnIndex) note.noteOffIndex++;
+		if (note.noteOnIndex >= noteOffIndex) note.noteOnIndex++;
+		if (note.noteOffIndex >= noteOffIndex) note.noteOffIndex++;
+	}
+
+	NoteLocation added;
+	added.id = (id != 0) ? id : mNextNoteId++;
+	added.found = true;
+	added.trackIndex = trackIndex;
+	added.noteOnIndex = noteOnIndex;
+	added.noteOffIndex = noteOffIndex;
+	added.startTick = noteOn.tick;
+	added.endTick = noteOff.tick;
+	added.pitch = pitch;
+	added.velocity = noteOn.mm.getVelocity();
+
+	auto pos = std::lower_bound(index.begin(), index.end(), added,
+		[](const NoteLocation& a, const NoteLocation& b) { return a.noteOnIndex < b.noteOnIndex; });
+	size_t position = static_cast<size_t>(pos - index.begin());
+	index.insert(pos, added);
+	UpdateSlotsFrom(trackIndex, position);
+	mIntervalIndexDirty[trackIndex] = true;
+	return added;
+}
+
+void TrackSet::RemoveNote(const NoteLocation& note)
+{
+	NoteLocation target = ResolveNote(note);
+	if (!target.found) return;
+
+	Track& track = mTracks[target.trackIndex];
+	MarkTrackChanged(target.trackIndex);
+	track.erase(track.begin() + target.noteOffIndex);
+	track.erase(track.begin() + target.noteOnIndex);
+
+	if (mNoteIndexDirty[target.trackIndex])
+	{
+		ForgetNoteId(target.id);
+		return;
+	}
+
+	NoteIndex& index = mNoteIndex[target.trackIndex];
+	auto removed = index.end();
+	bool sharedNoteOff = false;
+	for (auto it = index.begin(); it != index.end(); ++it)
+	{
+		if (it->noteOnIndex == target.noteOnIndex)
+		{
+			removed = it;
+		}
+		else if (it->noteOffIndex == target.noteOffIndex)
+		{
+			sharedNoteOff = true;  // Another NoteOn was paired with the removed NoteOff
+		}
+	}
+
+	if (removed == index.end() || sharedNoteOff)
+	{
+		ForgetNoteId(target.id);
+		InvalidateNoteIndex(target.trackIndex);
+		return;
+	}
+	size_t position = static_cast<size_t>(removed - index.begin());
+	mNoteSlots.erase(removed->id);
+	index.erase(removed);
+	mIntervalIndexDirty[target.trackIndex] = true;
+
+	// Close the gaps left by the two erased events
+	for (NoteLocation& other : index)
+	{
+		if (other.noteOnIndex > target.noteOffIndex) other.noteOnIndex--;
+		if (other.noteOffIndex > target.noteOffIndex) other.noteOffIndex--;
+		if (other.noteOnIndex > target.noteOnIndex) other.noteOnIndex--;
+		if (other.noteOffIndex > target.noteOnIndex) other.noteOffIndex--;
+	}
+	UpdateSlotsFrom(target.trackIndex, position);
+}
+
+NoteLocation TrackSet::MoveNote(const NoteLocation& note, uint64_t newStartTick, uint64_t newEndTick, ubyte newPitch)
+{
+	NoteLocation target = ResolveNote(note);
+	if (!target.found) return NoteLocation{};
+
+	const Track& track = mTracks[target.trackIndex];
+	TimedMidiEvent noteOn = track[target.noteOnIndex];
+	TimedMidiEvent noteOff = track[target.noteOffIndex];
+
+	noteOn.tick = newStartTick;
+	noteOn.mm.mData[1] = newPitch;
+	noteOff.tick = newEndTick;
+	noteOff.mm.mData[1] = newPitch;
+
+	RemoveNote(target);
+	return AddNote(target.trackIndex, noteOn, noteOff, target.id);
+}
+
+void TrackSet::SetNoteVelocity(const NoteLocation& note, ubyte velocity)
+{
+	NoteLocation target = ResolveNote(note);
+	if (!target.found) return;
+
+	mTracks[target.trackIndex][target.noteOnIndex].mm.mData[2] = velocity;
+	MarkTrackChanged(target.trackIndex);
+
+	if (mNoteIndexDirty[target.trackIndex]) return;
+
+	auto slot = mNoteSlots.find(target.id);
+	if (slot != mNoteSlots.end())
+	{
+		mNoteIndex[target.trackIndex][slot->second.position].velocity = velocity;
+		return;
+	}
+
+	for (NoteLocation& indexed : mNoteIndex[target.trackIndex])
+	{
+		if (indexed.noteOnIndex == target.noteOnIndex)
+		{
+			indexed.velocity = velocity;
+			break;
+		}
+	}
+}
+
+std::vector<NoteLocation> TrackSet::MoveNotes(const std::vector<NoteMove>& moves)
+{
+	BeginTransaction();
+	std::vector<NoteId> ids;
+	ids.reserve(moves.size());
+	for (const NoteMove& move : moves)
+	{
+		ids.push_back(QueueMoveNote(move.note, move.startTick, move.endTick, move.pitch));
+	}
+	CommitTransaction();
+
+	std::vector<NoteLocation> moved;
+	moved.reserve(ids.size());
+	for (NoteId id : ids)
+	{
+		moved.push_back(id != 0 ? FindNoteById(id) : NoteLocation{});
+	}
+	return moved;
+}
+
+void TrackSet::BeginTransaction()
+{
+	for (PendingEdits& edits : mPendingEdits)
+	{
+		edits.inserts.clear();
+		edits.removals.clear();
+		edits.eventRemovals.clear();
+		edits.noteIds.clear();
+	}
+}
+
+void TrackSet::QueueInsert(int trackIndex, const TimedMidiEvent& event)
+{
+	mPendingEdits[trackIndex].inserts.push_back(event);
+}
+
+void TrackSet::QueueRemoveEvent(int trackIndex, const TimedMidiEvent& event)
+{
+	mPendingEdits[trackIndex].eventRemovals.push_back(event);
+}
+
+NoteId TrackSet::QueueAddNote(int trackIndex, const TimedMidiEvent& noteOn, const TimedMidiEvent& noteOff, NoteId id)
+{
+	// Never hand out an id that still belongs to another note
+	if (id == 0 || mNoteSlots.count(id) > 0) id = mNextNoteId++;
+
+	PendingEdits& edits = mPendingEdits[trackIndex];
+	edits.inserts.push_back(noteOn);
+	edits.inserts.push_back(noteOff);
+
+	NoteLocation pending;
+	pending.id = id;
+	pending.startTick = noteOn.tick;
+	pending.endTick = noteOff.tick;
+	pending.pitch = noteOn.mm.getPitch();
+	edits.noteIds.push_back(pending);
+	return id;
+}
+
+void TrackSet::QueueRemoveNote(const NoteLocation& note)
+{
+	NoteLocation target = ResolveNote(note);
+	if (!target.found) return;
+
+	PendingEdits& edits = mPendingEdits[target.trackIndex];
+	edits.removals.push_back(target.noteOnIndex);
+	edits.removals.push_back(target.noteOffIndex);
+	ForgetNoteId(target.id);
+}
+
+NoteId TrackSet::QueueMoveNote(const NoteLocation& note, uint64_t newStartTick, uint64_t newEndTick, ubyte newPitch)
+{
+	NoteLocation target = ResolveNote(note);
+	if (!target.found) return 0;
+
+	const Track& track = mTracks[target.trackIndex];
+	TimedMidiEvent noteOn = track[target.noteOnIndex];
+	TimedMidiEvent noteOff = track[target.noteOffIndex];
+
+	noteOn.tick = newStartTick;
+	noteOn.mm.mData[1] = newPitch;
+	noteOff.tick = newEndTick;
+	noteOff.mm.mData[1] = newPitch;
+
+	// The rebuild gives the id back to whichever note ends up at the new pitch/start/end
+	PendingEdits& edits = mPendingEdits[target.trackIndex];
+	edits.removals.push_back(target.noteOnIndex);
+	edits.removals.push_back(target.noteOffIndex);
+	edits.inserts.push_back(noteOn);
+	edits.inserts.push_back(noteOff);
+
+	target.startTick = newStartTick;
+	target.endTick = newEndTick;
+	target.pitch = newPitch;
+	edits.noteIds.push_back(target);
+	return target.id;
+}
+
+void TrackSet::CommitTransaction()
+{
+	for (int t = 0; t < MidiConstants::CHANNEL_COUNT; t++)
+	{
+		if (mPendingEdits[t].empty()) continue;
+		ApplyEdits(t);
+	}
+}
+
 std::vector<NoteLocation> TrackSet::GetNotesFromTrack(const Track& track, int trackIndex)
 {
 	std::vector<NoteLocation> result;
 
 	if (track.empty()) return result;
 
-	size_t end = track.size();
-	for (size_t i = 0; i < end; i++)
+	// NoteOns still waiting for a NoteOff, per pitch (positions in result).
+	// A NoteOff closes every pending NoteOn of its pitch, which matches pairing
+	// each NoteOn with the first NoteOff of the same pitch that follows it.
+	std::array<std::vector<size_t>, MidiConstants::MIDI_NOTE_COUNT> pending;
+	std::vector<bool> paired;
+
+	for (size_t i = 0; i < track.size(); i++)
 	{
-		const TimedMidiEvent& noteOn = track[i];
-		// if the note type is not note on, continue until note on found
-		if (!noteOn.mm.isNoteOn()) continue;
+		const MidiMessage& mm = track[i].mm;
+		ubyte pitch = mm.getPitch() & 0x7F;
 
-		// Find corresponding note off
-		for (size_t j = i + 1; j < end; j++)
+		if (mm.isNoteOff())
 		{
-			const TimedMidiEvent& noteOff = track[j];
-			// Skip if not the corresponding note off
-			if (!noteOff.mm.isNoteOff() || noteOff.mm.getPitch() != noteOn.mm.getPitch()) continue;
+			for (size_t slot : pending[pitch])
+			{
+				result[slot].noteOffIndex = i;
+				result[slot].endTick = track[i].tick;
+				paired[slot] = true;
+			}
+			pending[pitch].clear();
+		}
 
+		// NoteOn with velocity 0 counts as both a NoteOff and a NoteOn, as in isNoteOn()
+		if (mm.isNoteOn())
+		{
 			NoteLocation note;
 			note.found = true;
 			note.trackIndex = trackIndex;
 			note.noteOnIndex = i;
-			note.noteOffIndex = j;
-			note.startTick = noteOn.tick;
-			note.endTick = noteOff.tick;
-			note.pitch = noteOn.mm.getPitch();
-			note.velocity = noteOn.mm.getVelocity();
+			note.startTick = track[i].tick;
+			note.pitch = mm.getPitch();
+			note.velocity = mm.getVelocity();
+			pending[pitch].push_back(result.size());
 			result.push_back(note);
-			break;
+			paired.push_back(false);
 		}
 	}
 
+	// Drop NoteOns that never found a NoteOff
+	size_t kept = 0;
+	for (size_t i = 0; i < result.size(); i++)
+	{
+		if (paired[i]) result[kept++] = result[i];
+	}
+	result.resize(kept);
+
 	return result;
 }
 
@@ -183,59 +503,90 @@ void TrackSet::SortTrack(Track& track)
 {
 	if (track.empty()) return;
 
-	std::sort(track.begin(), track.end(), [](const TimedMidiEvent& a, const TimedMidiEvent& b)
-	{
-		return a.tick < b.tick;
-	});
+	std::stable_sort(track.begin(), track.end(), EventPrecedes);
 }
 
 void TrackSet::SeparateOverlappingNotes(Track& buffer)
 {
 	if (buffer.size() < 2) return;
 
-	// Sort by tick to ensure chronological order
-	SortTrack(buffer);
-
-	std::set<size_t> movedIndices; // Track which NoteOffs we've already moved
+	// Recording, pasting and merges keep buffers sorted, only sort when needed
+	if (!std::is_sorted(buffer.begin(), buffer.end(), EventPrecedes))
+	{
+		SortTrack(buffer);
+	}
 
-	// Process each NoteOn to find bad pairs
+	// NoteOffs owed to a channel/pitch, oldest first (linked through the pool)
+	constexpr size_t NONE = SIZE_MAX;
+	struct OwedNoteOff
+	{
+		uint64_t tick = 0;  // Where the NoteOff must move to
+		size_t next = NONE;
+	};
+	struct OpenNote
+	{
+		bool noteOnPending = false;  // Last event of this channel/pitch was a NoteOn
+		size_t firstOwed = NONE;
+		size_t lastOwed = NONE;
+	};
+	std::vector<OpenNote> open(MidiConstants::TOTAL_CHANNELS * MidiConstants::MIDI_NOTE_COUNT);
+	std::vector<OwedNoteOff> owed;
+
+	// One sweep: a NoteOn that follows a NoteOn of the same channel/pitch owes the next
+	// NoteOff a move to just before it. Moved NoteOffs are taken out and merged back below.
+	Track moved;
+	size_t kept = 0;
 	for (size_t i = 0; i < buffer.size(); i++)
 	{
-		auto& eventI = buffer[i].mm;
-		if (!eventI.isNoteOn()) continue;
-
-		// Look for the next event with the same channel and pitch
-		for (size_t j = i + 1; j < buffer.size(); j++)
+		const MidiMessage& mm = buffer[i].mm;
+		bool noteOff = mm.isNoteOff();
+		if (!noteOff && !mm.isNoteOn())
 		{
-			auto& eventJ = buffer[j].mm;
-			if (eventI.getPitch() != eventJ.getPitch() ||
-				eventI.getChannel() != eventJ.getChannel()) continue;
+			buffer[kept++] = buffer[i];
+			continue;
+		}
 
-			// Found next event with same pitch
-			if (eventJ.isNoteOn())
+		OpenNote& note = open[mm.getChannel() * MidiConstants::MIDI_NOTE_COUNT + mm.getPitch()];
+		if (!noteOff)
+		{
+			if (note.noteOnPending)
 			{
-				// Bad pair detected! Two NoteOns in a row
-				// Find the first NoteOff with this pitch after j that hasn't been moved yet
-				for (size_t k = j + 1; k < buffer.size(); k++)
-				{
-					auto& eventK = buffer[k].mm;
-					if (eventK.isNoteOff() && eventK.getPitch() == eventI.getPitch() &&
-						movedIndices.find(k) == movedIndices.end())
-					{
-						// Move this NoteOff to prevent overlap with the second NoteOn
-						buffer[k].tick = buffer[j].tick - MidiConstants::NOTE_SEPARATION_TICKS;
-						movedIndices.insert(k);
-						break;
-					}
-				}
+				// Two NoteOns in a row, the first note must end before this one starts
+				OwedNoteOff debt;
+				debt.tick = buffer[i].tick - MidiConstants::NOTE_SEPARATION_TICKS;
+				owed.push_back(debt);
+				size_t debtIndex = owed.size() - 1;
+				if (note.lastOwed == NONE) note.firstOwed = debtIndex;
+				else owed[note.lastOwed].next = debtIndex;
+				note.lastOwed = debtIndex;
 			}
-			// Whether it's a NoteOn or NoteOff, we've found the next event for this pitch
-			break;
+			note.noteOnPending = true;
+			buffer[kept++] = buffer[i];
+			continue;
+		}
+
+		note.noteOnPending = false;
+		if (note.firstOwed == NONE)
+		{
+			buffer[kept++] = buffer[i];
+			continue;
 		}
+
+		TimedMidiEvent shifted = buffer[i];
+		shifted.tick = owed[note.firstOwed].tick;
+		moved.push_back(shifted);
+		note.firstOwed = owed[note.firstOwed].next;
+		if (note.firstOwed == NONE) note.lastOwed = NONE;
 	}
 
-	// Re-sort after moving NoteOffs
-	SortTrack(buffer);
+	if (moved.empty()) return;
+
+	// Moved NoteOffs only go earlier, merge them back instead of re-sorting
+	buffer.resize(kept);
+	std::stable_sort(moved.begin(), moved.end(), EventPrecedes);
+	size_t middle = buffer.size();
+	buffer.insert(buffer.end(), moved.begin(), moved.end());
+	std::inplace_merge(buffer.begin(), buffer.begin() + middle, buffer.end(), EventPrecedes);
 }
 
 void TrackSet::QuantizeTrack(Track& track, uint64_t gridSize)
@@ -272,19 +623,232 @@ void TrackSet::QuantizeTrack(Track& track, uint64_t gridSize)
 
 void TrackSet::FinalizeRecording(Track& recordingBuffer)
 {
+	// Sort the buffer once and merge it into each touched track, existing tracks are already sorted
+	BeginTransaction();
 	for (const auto& event : recordingBuffer)
 	{
-		ubyte channel = event.mm.getChannel();
-		mTracks[channel].push_back(event);
+		QueueInsert(event.mm.getChannel(), event);
 	}
-	Sort();
+	CommitTransaction();
 	recordingBuffer.clear();
 }
 
-void TrackSet::Sort()
+TrackSet::MemoryReport TrackSet::GetMemoryReport() const
+{
+	MemoryReport report;
+	for (const Track& track : mTracks)
+	{
+		report.eventCount += track.size();
+		report.trackBytes += track.capacity() * sizeof(TimedMidiEvent);
+		report.compactBytes += CompactTrack(track).GetMemoryBytes();
+	}
+	return report;
+}
+
+const TrackSet::NoteIndex& TrackSet::GetNoteIndex(int trackIndex) const
+{
+	if (mNoteIndexDirty[trackIndex])
+	{
+		const Track& track = mTracks[trackIndex];
+		NoteIndex previous = std::move(mNoteIndex[trackIndex]);
+		mNoteIndex[trackIndex] = GetNotesFromTrack(track, trackIndex);
+		mNoteIndexDirty[trackIndex] = false;
+
+		AssignNoteIds(trackIndex, previous, mNoteIndex[trackIndex]);
+		UpdateSlotsFrom(trackIndex, 0);
+
+		size_t noteOnCount = std::count_if(track.begin(), track.end(),
+			[](const TimedMidiEvent& e) { return e.mm.isNoteOn(); });
+		mUnpairedNoteOns[trackIndex] = noteOnCount - mNoteIndex[trackIndex].size();
+	}
+	return mNoteIndex[trackIndex];
+}
+
+const NoteIntervalIndex& TrackSet::GetIntervalIndex(int trackIndex) const
+{
+	const NoteIndex& notes = GetNoteIndex(trackIndex);
+	if (mIntervalIndexDirty[trackIndex])
+	{
+		mIntervalIndex[trackIndex].Build(notes);
+		mIntervalIndexDirty[trackIndex] = false;
+	}
+	return mIntervalIndex[trackIndex];
+}
+
+void TrackSet::QueryTrack(int trackIndex, uint64_t minTick, uint64_t maxTick, ubyte minPitch, ubyte maxPitch, std::vector<NoteLocation>& result) const
+{
+	const NoteIntervalIndex& intervals = GetIntervalIndex(trackIndex);
+	const NoteIndex& notes = mNoteIndex[trackIndex];
+
+	mQueryScratch.clear();
+	intervals.Query(minTick, maxTick, minPitch, maxPitch, mQueryScratch);
+	for (uint32_t position : mQueryScratch)
+	{
+		result.push_back(notes[position]);
+	}
+}
+
+void TrackSet::AssignNoteIds(int trackIndex, const NoteIndex& previous, NoteIndex& rebuilt) const
+{
+	// Candidates ordered by pitch/start/end, pending ids ahead of previous ones with the same key
+	std::vector<NoteLocation> candidates = std::move(mPendingIds[trackIndex]);
+	mPendingIds[trackIndex].clear();
+	for (const NoteLocation& note : previous)
+	{
+		if (note.id != 0) candidates.push_back(note);
+	}
+
+	auto byKey = [](const NoteLocation& a, const NoteLocation& b)
+	{
+		return std::tie(a.pitch, a.startTick, a.endTick) < std::tie(b.pitch, b.startTick, b.endTick);
+	};
+	std::stable_sort(candidates.begin(), candidates.end(), byKey);
+
+	std::unordered_set<NoteId> taken;
+	auto claim = [&](NoteLocation& note, bool sameEnd)
+	{
+		NoteLocation key;
+		key.pitch = note.pitch;
+		key.startTick = note.startTick;
+		auto it = std::lower_bound(candidates.begin(), candidates.end(), key, byKey);
+		for (; it != candidates.end() && it->pitch == note.pitch && it->startTick == note.startTick; ++it)
+		{
+			if (it->id == 0 || (sameEnd && it->endTick != note.endTick)) continue;
+
+			NoteId id = it->id;
+			it->id = 0;
+			if (taken.insert(id).second)
+			{
+				note.id = id;
+				return;
+			}
+		}
+	};
+
+	for (NoteLocation& note : rebuilt)
+	{
+		claim(note, true);
+	}
+	for (NoteLocation& note : rebuilt)
+	{
+		if (note.id == 0) claim(note, false);
+	}
+	for (NoteLocation& note : rebuilt)
+	{
+		if (note.id == 0) note.id = mNextNoteId++;
+	}
+
+	// Ids nobody claimed belonged to notes that are gone
+	for (const NoteLocation& candidate : candidates)
+	{
+		if (candidate.id != 0 && taken.count(candidate.id) == 0)
+		{
+			mNoteSlots.erase(candidate.id);
+		}
+	}
+}
+
+void TrackSet::UpdateSlotsFrom(int trackIndex, size_t position) const
 {
-	for (auto& track : mTracks)
+	const NoteIndex& index = mNoteIndex[trackIndex];
+	for (size_t i = position; i < index.size(); i++)
 	{
-		SortTrack(track);
+		mNoteSlots[index[i].id] = NoteSlot{trackIndex, i};
 	}
 }
+
+void TrackSet::ApplyEdits(int trackIndex)
+{
+	PendingEdits& edits = mPendingEdits[trackIndex];
+	Track& track = mTracks[trackIndex];
+
+	std::stable_sort(edits.inserts.begin(), edits.inserts.end(), EventPrecedes);
+	std::stable_sort(edits.eventRemovals.begin(), edits.eventRemovals.end(), EventPrecedes);
+	std::sort(edits.removals.begin(), edits.removals.end());
+	edits.removals.erase(std::unique(edits.removals.begin(), edits.removals.end()), edits.removals.end());
+
+	// Events removed by value are matched within their tick, each match used once
+	std::vector<bool> matched(edits.eventRemovals.size(), false);
+	size_t firstOnTick = 0;
+	auto removeByValue = [&](const TimedMidiEvent& event)
+	{
+		while (firstOnTick < edits.eventRemovals.size() && edits.eventRemovals[firstOnTick].tick < event.tick)
+		{
+			firstOnTick++;
+		}
+		for (size_t r = firstOnTick; r < edits.eventRemovals.size() && edits.eventRemovals[r].tick == event.tick; r++)
+		{
+			if (!matched[r] && edits.eventRemovals[r].mm == event.mm)
+			{
+				matched[r] = true;
+				return true;
+			}
+		}
+		return false;
+	};
+
+	// Queued events go after existing events they don't precede, like InsertSorted
+	Track merged;
+	merged.reserve(track.size() + edits.inserts.size());
+	auto insert = edits.inserts.begin();
+	auto removal = edits.removals.begin();
+	for (size_t i = 0; i < track.size(); i++)
+	{
+		if (removal != edits.removals.end() && *removal == i)
+		{
+			++removal;
+			continue;
+		}
+		if (removeByValue(track[i])) continue;
+
+		while (insert != edits.inserts.end() && EventPrecedes(*insert, track[i]))
+		{
+			merged.push_back(*insert++);
+		}
+		merged.push_back(track[i]);
+	}
+	merged.insert(merged.end(), insert, edits.inserts.end());
+	track.swap(merged);
+	MarkTrackChanged(trackIndex);
+
+	// Slots point at the track until the rebuild finds each note's position (or drops the id)
+	for (const NoteLocation& pending : edits.noteIds)
+	{
+		mPendingIds[trackIndex].push_back(pending);
+		mNoteSlots[pending.id] = NoteSlot{trackIndex, 0};
+	}
+	InvalidateNoteIndex(trackIndex);
+
+	edits.inserts.clear();
+	edits.removals.clear();
+	edits.eventRemovals.clear();
+	edits.noteIds.clear();
+}
+
+void TrackSet::ForgetNoteId(NoteId id)
+{
+	auto slot = mNoteSlots.find(id);
+	if (slot == mNoteSlots.end()) return;
+
+	NoteIndex& index = mNoteIndex[slot->second.trackIndex];
+	if (slot->second.position < index.size() && index[slot->second.position].id == id)
+	{
+		index[slot->second.position].id = 0;
+	}
+	mNoteSlots.erase(slot);
+}
+
+bool TrackSet::OverlapsIndexedNote(int trackIndex, uint64_t startTick, uint64_t endTick, ubyte pitch) const
+{
+	mQueryScratch.clear();
+	GetIntervalIndex(trackIndex).Query(startTick, endTick, pitch, pitch, mQueryScratch);
+	return !mQueryScratch.empty();
+}
+
+size_t TrackSet::InsertSorted(Track& track, const TimedMidiEvent& event)
+{
+	auto pos = std::upper_bound(track.begin(), track.end(), event, EventPrecedes);
+	size_t index = static_cast<size_t>(pos - track.begin());
+	track.insert(pos, event);
+	return index;
+}
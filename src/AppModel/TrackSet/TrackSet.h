@@ -4,64 +4,78 @@
 #include <vector>
 #include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include "RtMidiWrapper/MidiMessage/MidiMessage.h"
 #include "MidiConstants.h"
 #include "NoteTypes.h"
-using namespace MidiInterface;
+#include "Track.h"
+#include "NoteIntervalIndex.h"
+#include "ChaseIndex.h"
 
-struct TimedMidiEvent
+/// Immutable copy of every track, played by the PlaybackEngine while the GUI keeps editing.
+/// Tracks that didn't change between two snapshots share one copy (and its chase index).
+struct TrackSnapshot
 {
-	MidiMessage mm;
-	uint64_t	tick = 0;
+	std::array<std::shared_ptr<const Track>, MidiConstants::CHANNEL_COUNT> tracks;
+	std::array<std::shared_ptr<const ChaseIndex>, MidiConstants::CHANNEL_COUNT> chase;  // State at any tick of each track
 };
 
-using Track = std::vector<TimedMidiEvent>;
-using TrackBank = std::array<Track, MidiConstants::CHANNEL_COUNT>;  // CHANNEL_COUNT tracks (channel 16 reserved for metronome)
-
 /// TrackSet manages MIDI track data for all channels.
 ///
 /// Responsibilities:
 /// - Store MIDI events organized by channel (15 tracks)
-/// - Provide playback iteration with FindStart/PlayBack
+/// - Publish immutable snapshots of the tracks for playback, copying only changed tracks
 /// - Find notes by position, pitch, or region
+/// - Own a per-track note index (NoteOn/NoteOff pairs) kept in sync by the note edit methods
+/// - Give every indexed note a stable NoteId and find notes by id in O(1)
+/// - Apply batches of queued edits with one merge pass per touched track (transactions)
+/// - Answer region and point queries through a per-pitch interval index
 /// - Static helpers for track operations (sort, quantize, overlap separation)
 ///
 /// Usage:
 ///   TrackSet trackSet;
-///   Track& track = trackSet.GetTrack(0);
-///   track.push_back({midiMessage, tick});
-///   trackSet.FindStart(0);
-///   auto messages = trackSet.PlayBack(currentTick);
+///   NoteLocation note = trackSet.AddNote(0, noteOn, noteOff);
+///   trackSet.MoveNote(note, newStartTick, newEndTick, newPitch);
+///   auto snapshot = trackSet.GetSnapshot();  // hand to the PlaybackEngine
 class TrackSet
 {
 public:
 	// Track Access
 
-	/// Get a track by channel number
-	Track& GetTrack(ubyte channelNumber) { return mTracks[channelNumber]; }
+	/// Get a track by channel number for direct editing.
+	/// Invalidates the track's note index, prefer the note edit methods for single notes.
+	Track& GetTrack(ubyte channelNumber) { InvalidateNoteIndex(channelNumber); MarkTrackChanged(channelNumber); return mTracks[channelNumber]; }
+
+	/// Get a track by channel number (read only, keeps the note index)
+	const Track& GetTrack(ubyte channelNumber) const { return mTracks[channelNumber]; }
 
 	/// Check if a specific track is empty
-	bool IsTrackEmpty(ubyte channelNumber) { return GetTrack(channelNumber).empty(); }
+	bool IsTrackEmpty(ubyte channelNumber) const { return mTracks[channelNumber].empty(); }
 
 	/// Check if all tracks are empty (no notes anywhere)
 	bool IsEmpty() const;
 
 	// Playback
 
-	/// Get messages scheduled at or before the current tick
-	std::vector<MidiMessage> PlayBack(uint64_t currentTick);
-
-	/// Set playback iterators to start from a specific tick
-	void FindStart(uint64_t startTick);
+	/// Get an immutable copy of all tracks for the playback engine.
+	/// Returns the same snapshot until a track changes, then copies only the changed tracks.
+	std::shared_ptr<const TrackSnapshot> GetSnapshot() const;
 
 	// Note Finding
 
 	/// Find a note at a specific tick and pitch (searches all tracks)
 	NoteLocation FindNoteAt(uint64_t tick, ubyte pitch) const;
 
+	/// Find a note by its id (O(1) while the track's index is current)
+	NoteLocation FindNoteById(NoteId id) const;
+
 	/// Find a note in a specific track by its exact boundaries
 	NoteLocation FindNoteInTrack(int trackIndex, uint64_t startTick, uint64_t endTick, ubyte pitch) const;
 
+	/// Re-find a note whose indices may be stale: by id, then by its indices, then by its boundaries
+	NoteLocation ResolveNote(const NoteLocation& note) const;
+
 	/// Find all notes overlapping a region
 	/// @param trackIndex Specific track to search, or -1 for all tracks
 	std::vector<NoteLocation> FindNotesInRegion(uint64_t minTick, uint64_t maxTick, ubyte minPitch, ubyte maxPitch, int trackIndex = -1) const;
@@ -72,15 +86,79 @@ public:
 	/// Get all raw MIDI events from all tracks (for debugging)
 	std::vector<TimedMidiEvent> GetAllTimedMidiEvents();
 
+	// Note Editing (updates the note index incrementally, notes keep their ids)
+
+	/// Insert a NoteOn/NoteOff pair at their sorted positions
+	/// @param id Id to give the note (e.g. restoring a deleted note on undo), 0 assigns a new one
+	/// @return Location of the inserted note
+	NoteLocation AddNote(int trackIndex, const TimedMidiEvent& noteOn, const TimedMidiEvent& noteOff, NoteId id = 0);
+
+	/// Remove a note's NoteOn/NoteOff pair
+	void RemoveNote(const NoteLocation& note);
+
+	/// Move a note to new boundaries and pitch (velocity and channel are kept)
+	/// @return Location of the note after the move
+	NoteLocation MoveNote(const NoteLocation& note, uint64_t newStartTick, uint64_t newEndTick, ubyte newPitch);
+
+	/// Change the velocity of a note's NoteOn event
+	void SetNoteVelocity(const NoteLocation& note, ubyte velocity);
+
+	/// New boundaries and pitch for one note of a batch move
+	struct NoteMove
+	{
+		NoteLocation note;
+		uint64_t startTick = 0;
+		uint64_t endTick = 0;
+		ubyte pitch = 0;
+	};
+
+	/// Move many notes with one merge pass per touched track, notes keep their ids
+	/// @return Locations after the move in the order of moves (not found if a note couldn't be resolved)
+	std::vector<NoteLocation> MoveNotes(const std::vector<NoteMove>& moves);
+
+	// Transactions (queued edits see the tracks as they were at BeginTransaction)
+
+	/// Start queueing edits. Don't edit tracks through GetTrack until CommitTransaction.
+	void BeginTransaction();
+
+	/// Queue a single event insert (placed after equal events, see EventPrecedes)
+	void QueueInsert(int trackIndex, const TimedMidiEvent& event);
+
+	/// Queue removal of one event matching tick and MIDI bytes (no-op if there is none)
+	void QueueRemoveEvent(int trackIndex, const TimedMidiEvent& event);
+
+	/// Queue a NoteOn/NoteOff pair insert
+	/// @param id Id to give the note, 0 assigns a new one
+	/// @return Id the note has after the commit
+	NoteId QueueAddNote(int trackIndex, const TimedMidiEvent& noteOn, const TimedMidiEvent& noteOff, NoteId id = 0);
+
+	/// Queue removal of a note's NoteOn/NoteOff pair
+	void QueueRemoveNote(const NoteLocation& note);
+
+	/// Queue moving a note to new boundaries and pitch (velocity and channel are kept)
+	/// @return Id the note has after the commit (0 if the note wasn't found)
+	NoteId QueueMoveNote(const NoteLocation& note, uint64_t newStartTick, uint64_t newEndTick, ubyte newPitch);
+
+	/// Apply all queued edits: one merge pass per touched track, each note index invalidated once
+	void CommitTransaction();
+
 	// Static Track Helpers
 
-	/// Extract note pairs from a single track
+	/// Extract note pairs from a single track in one pass
 	/// @param trackIndex Index to assign to notes (use 0 for non-trackset tracks like recording buffer)
 	static std::vector<NoteLocation> GetNotesFromTrack(const Track& track, int trackIndex = 0);
 
-	/// Sort a track by tick
+	/// Sort a track by tick, NoteOffs ahead of other events on the same tick (stable otherwise)
 	static void SortTrack(Track& track);
 
+	/// Track order: by tick, and on the same tick a NoteOff goes first so a note ending
+	/// where a same-pitch note starts pairs with its own NoteOn
+	static bool EventPrecedes(const TimedMidiEvent& a, const TimedMidiEvent& b)
+	{
+		if (a.tick != b.tick) return a.tick < b.tick;
+		return a.mm.isNoteOff() && !b.mm.isNoteOff();
+	}
+
 	/// Separate overlapping notes during loop recording.
 	/// When consecutive NoteOn messages of same pitch/channel occur,
 	/// shifts NoteOff of first note to keep them as separate notes.
@@ -93,13 +171,90 @@ public:
 
 	// Recording
 
-	/// Finalize recording by moving events from buffer to tracks (clears buffer after)
+	/// Finalize recording by merging events from buffer into tracks (clears buffer after)
 	void FinalizeRecording(Track& recordingBuffer);
 
+	// Diagnostics
+
+	/// Event storage footprint: what the tracks hold now, and what CompactTrack would need
+	struct MemoryReport
+	{
+		size_t eventCount = 0;
+		size_t trackBytes = 0;    // Capacity of the Track vectors
+		size_t compactBytes = 0;  // Same events encoded as CompactTrack
+	};
+
+	/// Measure event storage for all tracks (encodes each track once, O(n))
+	MemoryReport GetMemoryReport() const;
+
 private:
+	using NoteIndex = std::vector<NoteLocation>;  // Notes of one track, ordered by noteOnIndex
+
+	/// Where a note id currently lives in mNoteIndex
+	struct NoteSlot
+	{
+		int trackIndex = -1;
+		size_t position = 0;
+	};
+
+	/// Edits queued for one track by the open transaction
+	struct PendingEdits
+	{
+		Track inserts;                      // Events to merge in, unsorted
+		std::vector<size_t> removals;       // Event indices to drop, as of BeginTransaction
+		Track eventRemovals;                // Events to drop, matched by tick and MIDI bytes
+		std::vector<NoteLocation> noteIds;  // Ids for queued notes, handed out on rebuild
+
+		bool empty() const { return inserts.empty() && removals.empty() && eventRemovals.empty(); }
+	};
+
 	TrackBank mTracks;
-	int iterators[MidiConstants::CHANNEL_COUNT]{-1};
+	std::array<uint64_t, MidiConstants::CHANNEL_COUNT> mTrackVersions{};  // Bumped on every edit
+	mutable std::shared_ptr<const TrackSnapshot> mSnapshot;
+	mutable std::array<uint64_t, MidiConstants::CHANNEL_COUNT> mSnapshotVersions{};  // Track versions in mSnapshot
+	mutable std::array<NoteIndex, MidiConstants::CHANNEL_COUNT> mNoteIndex;
+	mutable std::array<bool, MidiConstants::CHANNEL_COUNT> mNoteIndexDirty{};
+	mutable std::array<size_t, MidiConstants::CHANNEL_COUNT> mUnpairedNoteOns{};  // NoteOns with no NoteOff
+	mutable std::array<NoteIntervalIndex, MidiConstants::CHANNEL_COUNT> mIntervalIndex;
+	mutable std::array<bool, MidiConstants::CHANNEL_COUNT> mIntervalIndexDirty{};
+	mutable std::vector<uint32_t> mQueryScratch;  // Reused by region queries to avoid allocating
+	mutable std::unordered_map<NoteId, NoteSlot> mNoteSlots;
+	mutable std::array<std::vector<NoteLocation>, MidiConstants::CHANNEL_COUNT> mPendingIds;  // Ids to hand to notes at their new pitch/start/end on rebuild
+	mutable NoteId mNextNoteId = 1;
+	std::array<PendingEdits, MidiConstants::CHANNEL_COUNT> mPendingEdits;
+
+	/// Mark a track as edited since the last snapshot
+	void MarkTrackChanged(int trackIndex) { mTrackVersions[trackIndex]++; }
+
+	/// Mark a track's note index (and the interval index built on it) for rebuild on next query
+	void InvalidateNoteIndex(int trackIndex) { mNoteIndexDirty[trackIndex] = true; mIntervalIndexDirty[trackIndex] = true; }
+
+	/// Get a track's note index, rebuilding it first if invalidated
+	const NoteIndex& GetNoteIndex(int trackIndex) const;
+
+	/// Get a track's interval index, rebuilding it first if the note index changed
+	const NoteIntervalIndex& GetIntervalIndex(int trackIndex) const;
+
+	/// Collect notes of one track overlapping a region into result
+	void QueryTrack(int trackIndex, uint64_t minTick, uint64_t maxTick, ubyte minPitch, ubyte maxPitch, std::vector<NoteLocation>& result) const;
+
+	/// Give rebuilt notes the ids they had before: pending ids first, then notes that kept
+	/// pitch, start and end, then notes that kept pitch and start. Other notes get new ids.
+	void AssignNoteIds(int trackIndex, const NoteIndex& previous, NoteIndex& rebuilt) const;
+
+	/// Point the slots of index entries from position on at their current positions
+	void UpdateSlotsFrom(int trackIndex, size_t position) const;
+
+	/// Merge a track's queued edits into it in one pass, O(n + k log k)
+	void ApplyEdits(int trackIndex);
+
+	/// Drop an id so a later rebuild can't hand it to another note
+	void ForgetNoteId(NoteId id);
+
+	/// Check if a note would overlap an indexed note of the same pitch
+	bool OverlapsIndexedNote(int trackIndex, uint64_t startTick, uint64_t endTick, ubyte pitch) const;
 
-	/// Sort all tracks by tick
-	void Sort();
+	/// Insert an event after all events that don't come after it (see EventPrecedes)
+	/// @return Index where the event was inserted
+	static size_t InsertSorted(Track& track, const TimedMidiEvent& event);
 };
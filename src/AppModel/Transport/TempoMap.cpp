@@ -0,0 +1,141 @@
+// TempoMap.cpp
+#include "TempoMap.h"
+#include <algorithm>
+#include <cmath>
+
+TempoMap::TempoMap(std::vector<Segment> segments)
+	: mSegments(std::move(segments))
+{
+	Rebuild();
+}
+
+TempoMap TempoMap::WithInitial(double tempo, int numerator, int denominator) const
+{
+	TempoMap map = *this;
+	map.mSegments[0].tempo = tempo;
+	map.mSegments[0].numerator = numerator;
+	map.mSegments[0].denominator = denominator;
+	map.Rebuild();
+	return map;
+}
+
+const TempoMap::Segment& TempoMap::GetSegmentAt(uint64_t tick) const
+{
+	auto next = std::upper_bound(mSegments.begin() + 1, mSegments.end(), tick,
+		[](uint64_t t, const Segment& s) { return t < s.tick; });
+	return *(next - 1);
+}
+
+uint64_t TempoMap::GetPosition(uint64_t tick) const
+{
+	const Segment& segment = GetSegmentAt(tick);
+	return segment.position + (tick - segment.tick) * segment.nsPerQuarter;
+}
+
+uint64_t TempoMap::GetTick(uint64_t position) const
+{
+	const Segment& segment = mSegments[FindByPosition(position)];
+	return segment.tick + (position - segment.position) / segment.nsPerQuarter;
+}
+
+uint64_t TempoMap::GetTicksPerMeasure(uint64_t tick) const
+{
+	const Segment& segment = GetSegmentAt(tick);
+	return TicksPerBeat(segment) * segment.numerator;
+}
+
+uint64_t TempoMap::GetMeasureStart(uint64_t tick) const
+{
+	const Segment& segment = GetSegmentAt(tick);
+	uint64_t ticksPerMeasure = TicksPerBeat(segment) * segment.numerator;
+	return segment.barTick + (tick - segment.barTick) / ticksPerMeasure * ticksPerMeasure;
+}
+
+TempoMap::Beat TempoMap::GetNextBeat(uint64_t tick) const
+{
+	auto next = std::upper_bound(mSegments.begin() + 1, mSegments.end(), tick,
+		[](uint64_t t, const Segment& s) { return t < s.tick; });
+
+	for (auto segment = next - 1; ; ++segment, ++next)
+	{
+		uint64_t from = std::max(tick, segment->tick);
+		uint64_t ticksPerBeat = TicksPerBeat(*segment);
+		uint64_t beat = (from - segment->barTick + ticksPerBeat - 1) / ticksPerBeat;
+		uint64_t beatTick = segment->barTick + beat * ticksPerBeat;
+
+		// No beat left in this segment, the next one has its own grid
+		if (next != mSegments.end() && beatTick >= next->tick) continue;
+
+		return Beat{beatTick, beat % segment->numerator == 0};
+	}
+}
+
+void TempoMap::Rebuild()
+{
+	std::stable_sort(mSegments.begin(), mSegments.end(),
+		[](const Segment& a, const Segment& b) { return a.tick < b.tick; });
+
+	// Before the first change the defaults apply
+	if (mSegments.empty() || mSegments.front().tick != 0)
+	{
+		mSegments.insert(mSegments.begin(), Segment{});
+	}
+
+	std::vector<Segment> segments;
+	segments.reserve(mSegments.size());
+	for (Segment segment : mSegments)
+	{
+		if (!(segment.tempo > 0.0)) segment.tempo = MidiConstants::DEFAULT_TEMPO;
+		segment.numerator = std::max(segment.numerator, 1);
+		segment.denominator = std::clamp(segment.denominator, 1, MidiConstants::TICKS_PER_QUARTER * 4);
+		segment.nsPerQuarter = NsPerQuarter(segment.tempo);
+
+		if (segments.empty())
+		{
+			segment.position = 0;
+			segment.barTick = 0;
+			segments.push_back(segment);
+			continue;
+		}
+
+		Segment& previous = segments.back();
+		if (segment.tick == previous.tick)
+		{
+			// The later change at a tick wins
+			segments.pop_back();
+			if (segments.empty())
+			{
+				segment.position = 0;
+				segment.barTick = 0;
+				segments.push_back(segment);
+				continue;
+			}
+		}
+
+		const Segment& before = segments.back();
+		bool sameMeter = segment.numerator == before.numerator && segment.denominator == before.denominator;
+		if (sameMeter && segment.nsPerQuarter == before.nsPerQuarter) continue;
+
+		segment.position = before.position + (segment.tick - before.tick) * before.nsPerQuarter;
+		segment.barTick = sameMeter ? before.barTick : segment.tick;
+		segments.push_back(segment);
+	}
+	mSegments = std::move(segments);
+}
+
+size_t TempoMap::FindByPosition(uint64_t position) const
+{
+	auto next = std::upper_bound(mSegments.begin() + 1, mSegments.end(), position,
+		[](uint64_t p, const Segment& s) { return p < s.position; });
+	return static_cast<size_t>(next - mSegments.begin()) - 1;
+}
+
+uint64_t TempoMap::TicksPerBeat(const Segment& segment)
+{
+	return MidiConstants::TICKS_PER_QUARTER * 4 / segment.denominator;
+}
+
+uint64_t TempoMap::NsPerQuarter(double tempo)
+{
+	return static_cast<uint64_t>(std::llround(60'000'000'000.0 / tempo));
+}
@@ -0,0 +1,91 @@
+// TempoMap.h
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "MidiConstants.h"
+
+/// TempoMap holds the tempo and time signature changes of a song.
+///
+/// Responsibilities:
+/// - Keep changes as segments sorted by tick, each with its start position precomputed
+/// - Convert between ticks and positions with a binary search over the segments
+/// - Find beat and measure lines (metronome, grid, measure jumps)
+///
+/// A position is a time in 1/TICKS_PER_QUARTER ns. A tick then lasts exactly nsPerQuarter
+/// positions, so conversions are exact and a playhead kept as a position never drifts.
+/// A time signature change starts a new measure; tempo changes keep the measure grid.
+///
+/// Usage:
+///   TempoMap map({{.tick = 0, .tempo = 120.0}, {.tick = 15360, .tempo = 90.0}});
+///   uint64_t ns = map.GetPosition(30720) / MidiConstants::TICKS_PER_QUARTER;
+///   uint64_t tick = map.GetTick(position);
+class TempoMap
+{
+public:
+	struct Segment
+	{
+		uint64_t tick = 0;
+		double tempo = MidiConstants::DEFAULT_TEMPO;
+		int numerator = MidiConstants::DEFAULT_TIME_SIGNATURE_NUMERATOR;
+		int denominator = MidiConstants::DEFAULT_TIME_SIGNATURE_DENOMINATOR;
+
+		// Derived, filled in by the map
+		uint64_t nsPerQuarter = 0;  // Also the length of one tick in positions
+		uint64_t position = 0;      // Position of tick
+		uint64_t barTick = 0;       // Where the measure grid of this time signature starts
+	};
+
+	struct Beat
+	{
+		uint64_t tick = 0;
+		bool isDownbeat = false;  // First beat of a measure
+	};
+
+	/// Default tempo and time signature from tick 0
+	TempoMap() : TempoMap(std::vector<Segment>{Segment{}}) { }
+
+	/// Changes in any order; the defaults apply before the first one, a later change at the same tick wins
+	explicit TempoMap(std::vector<Segment> segments);
+
+	/// All segments, the first at tick 0
+	const std::vector<Segment>& GetSegments() const { return mSegments; }
+
+	/// Copy with the first segment's tempo and time signature replaced
+	TempoMap WithInitial(double tempo, int numerator, int denominator) const;
+
+	/// Segment in effect at tick
+	const Segment& GetSegmentAt(uint64_t tick) const;
+
+	/// Position where tick starts
+	uint64_t GetPosition(uint64_t tick) const;
+
+	/// Tick playing at position
+	uint64_t GetTick(uint64_t position) const;
+
+	/// Quarter note length in ns at tick
+	uint64_t GetNsPerQuarter(uint64_t tick) const { return GetSegmentAt(tick).nsPerQuarter; }
+
+	/// Ticks per beat at tick (time signature denominator)
+	uint64_t GetTicksPerBeat(uint64_t tick) const { return TicksPerBeat(GetSegmentAt(tick)); }
+
+	/// Ticks per measure at tick
+	uint64_t GetTicksPerMeasure(uint64_t tick) const;
+
+	/// Start of the measure tick is in
+	uint64_t GetMeasureStart(uint64_t tick) const;
+
+	/// First beat at or after tick
+	Beat GetNextBeat(uint64_t tick) const;
+
+private:
+	std::vector<Segment> mSegments;
+
+	/// Sort, drop duplicates and fill in the derived fields
+	void Rebuild();
+
+	/// Index of the segment in effect at position
+	size_t FindByPosition(uint64_t position) const;
+
+	static uint64_t TicksPerBeat(const Segment& segment);
+	static uint64_t NsPerQuarter(double tempo);
+};
@@ -1,5 +1,6 @@
 // Transport.cpp
 #include "Transport.h"
+#include <cstdio>
 
 bool Transport::IsMoving() const
 {
@@ -23,6 +24,31 @@ void Transport::ToggleRecord()
 	else if (mState == State::Recording) mState = State::StopRecording;
 }
 
+Transport::BeatSettings Transport::GetBeatSettings() const
+{
+	const TempoMap::Segment& initial = mTempoMap->GetSegments().front();
+	return BeatSettings{initial.tempo, initial.numerator, initial.denominator};
+}
+
+void Transport::SetBeatSettings(const BeatSettings& settings)
+{
+	if (GetBeatSettings() == settings) return;
+
+	SetTempoMap(std::make_shared<const TempoMap>(mTempoMap->WithInitial(
+		settings.tempo, settings.timeSignatureNumerator, settings.timeSignatureDenominator)));
+}
+
+void Transport::SetTempoMap(std::shared_ptr<const TempoMap> tempoMap)
+{
+	// Keep the playhead tick and how far into it the playhead is
+	uint64_t tickStart = mTempoMap->GetPosition(mCurrentTick);
+	double fraction = static_cast<double>(mPosition - tickStart) / mTempoMap->GetNsPerQuarter(mCurrentTick);
+
+	mTempoMap = std::move(tempoMap);
+	uint64_t nsPerQuarter = mTempoMap->GetNsPerQuarter(mCurrentTick);
+	mPosition = mTempoMap->GetPosition(mCurrentTick) + static_cast<uint64_t>(fraction * nsPerQuarter);
+}
+
 void Transport::SetLoopSettings(const LoopSettings& settings)
 {
 	bool changed = (mLoopSettings.startTick != settings.startTick ||
@@ -68,12 +94,11 @@ uint64_t Transport::StartPlayBack()
 	return mStartPlayBackTick;
 }
 
-void Transport::UpdatePlayBack(uint64_t deltaMs)
+void Transport::UpdatePlayBack(uint64_t deltaNs)
 {
-	mCurrentTimeMs += deltaMs;
-	// Convert ms to ticks based on tempo
-	double beats = (mCurrentTimeMs / 60000.0) * mBeatSettings.tempo;
-	mCurrentTick = static_cast<uint64_t>(beats * mTicksPerQuarter);
+	// ns * ticksPerQuarter advances mPosition by exactly deltaNs, whatever the tempo
+	mPosition += deltaNs * MidiConstants::TICKS_PER_QUARTER;
+	mCurrentTick = mTempoMap->GetTick(mPosition);
 }
 
 void Transport::StopPlaybackIfActive()
@@ -96,17 +121,17 @@ void Transport::ShiftCurrentTime()
 	if (mShiftSpeed > MAX_SHIFT_SPEED)
 		mShiftSpeed = MAX_SHIFT_SPEED;
 
-	int shift = IsFastForwarding() ? mShiftSpeed : -mShiftSpeed;
-	if (shift < 0 && -shift > mCurrentTimeMs)
+	// Shift speed is in ms, mPosition in 1/TICKS_PER_QUARTER ns
+	uint64_t shift = static_cast<uint64_t>(mShiftSpeed) * 1'000'000 * MidiConstants::TICKS_PER_QUARTER;
+	if (IsFastForwarding())
 	{
-		mCurrentTimeMs = 0;
+		mPosition += shift;
 	}
 	else
 	{
-		mCurrentTimeMs += shift;
+		mPosition = (shift > mPosition) ? 0 : mPosition - shift;
 	}
-	double beats = (mCurrentTimeMs / 60000.0) * mBeatSettings.tempo;
-	mCurrentTick = static_cast<uint64_t>(beats * mTicksPerQuarter);
+	mCurrentTick = mTempoMap->GetTick(mPosition);
 }
 
 void Transport::ShiftToTick(uint64_t newTick)
@@ -114,91 +139,73 @@ void Transport::ShiftToTick(uint64_t newTick)
 	if (newTick > MidiConstants::MAX_TICK_VALUE) return;
 
 	mCurrentTick = newTick;
-	mCurrentTimeMs = (1.0f * newTick / mTicksPerQuarter) * (60000.0 / mBeatSettings.tempo);
+	mPosition = mTempoMap->GetPosition(newTick);
+}
+
+void Transport::LoopBack()
+{
+	uint64_t loopLength = mTempoMap->GetPosition(mLoopSettings.endTick) - mTempoMap->GetPosition(mLoopSettings.startTick);
+	mPosition = (loopLength > mPosition) ? 0 : mPosition - loopLength;
+	mCurrentTick = mTempoMap->GetTick(mPosition);
 }
 
 void Transport::Reset()
 {
-	mCurrentTimeMs = 0;
+	mPosition = 0;
 	mCurrentTick = 0;
 }
 
 void Transport::JumpToNextMeasure()
 {
-	auto ticksPerMeasure = GetTicksPerMeasure();
-	// If we are already lined up with a measure, add a full measure
-	if (GetCurrentTick() % GetTicksPerMeasure() == 0)
-	{
-		ShiftToTick(GetCurrentTick() + ticksPerMeasure);
-	}
-	// If we are in the middle of a measure
-	else
+	// First downbeat after the playhead, a time signature change may start a measure early
+	TempoMap::Beat beat = mTempoMap->GetNextBeat(GetCurrentTick() + 1);
+	while (!beat.isDownbeat)
 	{
-		uint64_t measureCount = GetCurrentTick() / ticksPerMeasure;
-		uint64_t newTick = (measureCount + 1) * ticksPerMeasure;
-		ShiftToTick(newTick);
+		beat = mTempoMap->GetNextBeat(beat.tick + 1);
 	}
+	ShiftToTick(beat.tick);
 }
 
 void Transport::JumpToPreviousMeasure()
 {
-	auto ticksPerMeasure = GetTicksPerMeasure();
-	uint64_t newTick;
-	// If we are already lined up with a measure, subtract a full measure
-	if (GetCurrentTick() % GetTicksPerMeasure() == 0)
-	{
-		newTick = GetCurrentTick() - ticksPerMeasure;
-	}
-	// If we are in the middle of a measure
-	else
-	{
-		uint64_t measureCount = GetCurrentTick() / ticksPerMeasure;
-		newTick = measureCount * ticksPerMeasure;
-	}
-	ShiftToTick(newTick);
+	uint64_t currentTick = GetCurrentTick();
+	if (currentTick == 0) return;
+
+	// If we are already lined up with a measure, go to the start of the one before
+	uint64_t measureStart = mTempoMap->GetMeasureStart(currentTick);
+	ShiftToTick(measureStart == currentTick ? mTempoMap->GetMeasureStart(currentTick - 1) : measureStart);
 }
 
-wxString Transport::GetFormattedTime(uint64_t timeMs) const
+std::string Transport::GetFormattedTime(uint64_t timeMs) const
 {
-	return wxString::Format("%02llu:%02llu:%03llu",
-		timeMs / 60000, (timeMs % 60000) / 1000, timeMs % 1000);
+	char text[32];
+	std::snprintf(text, sizeof(text), "%02llu:%02llu:%03llu",
+		static_cast<unsigned long long>(timeMs / 60000),
+		static_cast<unsigned long long>((timeMs % 60000) / 1000),
+		static_cast<unsigned long long>(timeMs % 1000));
+	return text;
 }
 
 Transport::BeatInfo Transport::CheckForBeat(uint64_t lastTick, uint64_t currentTick) const
 {
 	BeatInfo info;
 
-	// Calculate ticks per beat based on time signature
-	// Quarter note = mTicksPerQuarter (TICKS_PER_QUARTER)
-	// Whole note = TICKS_PER_QUARTER * 4
-	// Time signature bottom number determines note value (4 = quarter note)
-	uint64_t ticksPerBeat = GetTicksPerBeat();
-
-	// Which beat are we on?
-	uint64_t lastBeat = lastTick / ticksPerBeat;
-	uint64_t currentBeat = currentTick / ticksPerBeat;
-
 	// Did we cross a beat boundary, or are we starting at beat 0?
-	if (currentBeat > lastBeat || (lastTick == 0 && currentBeat == 0))
+	TempoMap::Beat beat = mTempoMap->GetNextBeat(lastTick == 0 ? 0 : lastTick + 1);
+	if (beat.tick > currentTick) return info;
+
+	// Report the last beat crossed, like the metronome hears it
+	for (TempoMap::Beat next = mTempoMap->GetNextBeat(beat.tick + 1); next.tick <= currentTick;
+		next = mTempoMap->GetNextBeat(next.tick + 1))
 	{
-		info.beatOccurred = true;
-		// Is this the first beat of a measure?
-		info.isDownbeat = (currentBeat % mBeatSettings.timeSignatureNumerator) == 0;
+		beat = next;
 	}
 
+	info.beatOccurred = true;
+	info.isDownbeat = beat.isDownbeat;
 	return info;
 }
 
-uint64_t Transport::GetTicksPerBeat() const
-{
-	return mTicksPerQuarter * 4 / mBeatSettings.timeSignatureDenominator;
-}
-
-uint64_t Transport::GetTicksPerMeasure() const
-{
-	return GetTicksPerBeat() * mBeatSettings.timeSignatureNumerator;
-}
-
 bool Transport::ShouldLoopBack(uint64_t currentTick) const
 {
 	return mLoopSettings.enabled && currentTick >= mLoopSettings.endTick;
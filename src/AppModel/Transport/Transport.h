@@ -1,22 +1,28 @@
 // Transport.h
 #pragma once
-#include "wx/string.h"
 #include "MidiConstants.h"
+#include "TempoMap.h"
 #include <functional>
+#include <memory>
+#include <string>
 
 /// Transport manages playback state, timing, and loop control.
 ///
 /// Responsibilities:
 /// - Track playback state (stopped, playing, recording, etc.)
-/// - Convert between time (ms) and ticks based on tempo
+/// - Convert between time and ticks through the tempo map, exactly (nanosecond clock readings,
+///   the playhead is kept as a TempoMap position so no fraction is ever dropped)
 /// - Manage loop region settings
 /// - Provide beat/measure detection for metronome
 ///
+/// The tempo map is an immutable snapshot, replaced as a whole on every change, so it can be
+/// shared with the PlaybackEngine.
+///
 /// Usage:
 ///   Transport transport;
 ///   transport.SetBeatSettings({120.0, 4, 4});  // 120 BPM, 4/4 time
 ///   transport.TogglePlay();
-///   transport.UpdatePlayBack(deltaMs);
+///   transport.UpdatePlayBack(deltaNs);
 ///   auto tick = transport.GetCurrentTick();
 class Transport
 {
@@ -37,6 +43,8 @@ public:
 		double tempo = MidiConstants::DEFAULT_TEMPO;
 		int timeSignatureNumerator = MidiConstants::DEFAULT_TIME_SIGNATURE_NUMERATOR;
 		int timeSignatureDenominator = MidiConstants::DEFAULT_TIME_SIGNATURE_DENOMINATOR;
+
+		bool operator==(const BeatSettings&) const = default;
 	};
 
 	struct LoopSettings
@@ -44,6 +52,8 @@ public:
 		bool enabled = false;
 		uint64_t startTick = 0;
 		uint64_t endTick = MidiConstants::DEFAULT_LOOP_END;  // 4 bars in 4/4 time
+
+		bool operator==(const LoopSettings&) const = default;
 	};
 
 	Transport() { }
@@ -86,11 +96,22 @@ public:
 
 	// Beat Settings
 
-	/// Get current beat settings (tempo, time signature)
-	BeatSettings GetBeatSettings() const { return mBeatSettings; }
+	/// Get beat settings at the start of the song (tempo, time signature)
+	BeatSettings GetBeatSettings() const;
+
+	/// Set beat settings at the start of the song, later changes stay (the playhead keeps its tick)
+	void SetBeatSettings(const BeatSettings& settings);
+
+	/// Get the tempo and time signature changes
+	const std::shared_ptr<const TempoMap>& GetTempoMap() const { return mTempoMap; }
 
-	/// Set beat settings
-	void SetBeatSettings(const BeatSettings& settings) { mBeatSettings = settings; }
+	/// Replace the tempo map (the playhead keeps its tick, time follows the new tempo)
+	void SetTempoMap(std::shared_ptr<const TempoMap> tempoMap);
+
+	// Tick/Time Conversion
+
+	/// Length of a quarter note in ns at the playhead (the tempo is kept at this resolution)
+	uint64_t GetNsPerQuarter() const { return mTempoMap->GetNsPerQuarter(mCurrentTick); }
 
 	// Loop Control
 
@@ -117,8 +138,8 @@ public:
 	/// Start playback from current position, returns starting tick
 	uint64_t StartPlayBack();
 
-	/// Update playback position based on elapsed milliseconds
-	void UpdatePlayBack(uint64_t deltaMs);
+	/// Update playback position based on elapsed nanoseconds
+	void UpdatePlayBack(uint64_t deltaNs);
 
 	/// Stop playback if currently playing or recording
 	void StopPlaybackIfActive();
@@ -126,6 +147,12 @@ public:
 	/// Get current tick position
 	uint64_t GetCurrentTick() const { return mCurrentTick; }
 
+	/// Get current time position in nanoseconds
+	uint64_t GetCurrentTimeNs() const { return mPosition / MidiConstants::TICKS_PER_QUARTER; }
+
+	/// Get current time position in milliseconds
+	uint64_t GetCurrentTimeMs() const { return GetCurrentTimeNs() / 1'000'000; }
+
 	/// Shift current time during fast forward/rewind (accelerates over time)
 	void ShiftCurrentTime();
 
@@ -135,6 +162,9 @@ public:
 	/// Jump directly to a specific tick
 	void ShiftToTick(uint64_t newTick);
 
+	/// Jump back by the loop length, keeping how far past loop end the playhead was
+	void LoopBack();
+
 	/// Reset to tick 0
 	void Reset();
 
@@ -147,21 +177,21 @@ public:
 	// Time Formatting
 
 	/// Get formatted time string for current position (MM:SS:mmm)
-	wxString GetFormattedTime() const { return GetFormattedTime(mCurrentTimeMs); }
+	std::string GetFormattedTime() const { return GetFormattedTime(GetCurrentTimeMs()); }
 
 	/// Get formatted time string for given milliseconds
-	wxString GetFormattedTime(uint64_t timeMs) const;
+	std::string GetFormattedTime(uint64_t timeMs) const;
 
 	// Beat Detection
 
 	/// Check if a beat occurred between lastTick and currentTick
 	BeatInfo CheckForBeat(uint64_t lastTick, uint64_t currentTick) const;
 
-	/// Get ticks per beat based on time signature
-	uint64_t GetTicksPerBeat() const;
+	/// Get ticks per beat based on the time signature at tick
+	uint64_t GetTicksPerBeat(uint64_t tick) const { return mTempoMap->GetTicksPerBeat(tick); }
 
-	/// Get ticks per measure based on time signature
-	uint64_t GetTicksPerMeasure() const;
+	/// Get ticks per measure based on the time signature at tick
+	uint64_t GetTicksPerMeasure(uint64_t tick) const { return mTempoMap->GetTicksPerMeasure(tick); }
 
 	// Loop Detection
 
@@ -178,12 +208,11 @@ public:
 
 private:
 	State mState = State::Stopped;
-	BeatSettings mBeatSettings;
+	std::shared_ptr<const TempoMap> mTempoMap = std::make_shared<const TempoMap>();
 	LoopSettings mLoopSettings;
-	uint64_t mCurrentTimeMs = 0;
 	uint64_t mStartPlayBackTick = 0;
 	uint64_t mCurrentTick = 0;
-	int mTicksPerQuarter = MidiConstants::TICKS_PER_QUARTER;
+	uint64_t mPosition = 0;  // Playhead as a TempoMap position (1/TICKS_PER_QUARTER ns)
 	const double DEFAULT_SHIFT_SPEED = 50.0;
 	const double MAX_SHIFT_SPEED = 1000.0;
 	double mShiftSpeed = DEFAULT_SHIFT_SPEED;
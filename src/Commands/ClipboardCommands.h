@@ -2,10 +2,12 @@
 #pragma once
 #include "Command.h"
 #include "AppModel/TrackSet/TrackSet.h"
+#include "AppModel/TrackSet/CompactTrack.h"
 #include "AppModel/Clipboard/Clipboard.h"
 #include <algorithm>
 #include <vector>
 #include <set>
+#include <utility>
 using namespace MidiInterface;
 
 // Clipboard Commands
@@ -50,15 +52,14 @@ public:
 		{
 			TrackSnapshot snapshot;
 			snapshot.trackIndex = trackIndex;
-			snapshot.originalTrack = mTrackSet.GetTrack(trackIndex);  // Copy entire track
+			snapshot.originalTrack = CompactTrack(std::as_const(mTrackSet).GetTrack(trackIndex));  // Copy entire track
 			mTrackSnapshots.push_back(snapshot);
 		}
 
-		// Add each clipboard note to its track
+		// Queue each clipboard note for its track, merged in one pass per track
+		mTrackSet.BeginTransaction();
 		for (const auto& clipNote : mClipboardNotes)
 		{
-			Track& track = mTrackSet.GetTrack(clipNote.trackIndex);
-
 			// Calculate absolute tick positions
 			uint64_t noteOnTick = mPasteTick + clipNote.relativeStartTick;
 			uint64_t noteOffTick = noteOnTick + clipNote.duration;
@@ -73,10 +74,9 @@ public:
 			noteOff.tick = noteOffTick;
 			noteOff.mm = MidiMessage::NoteOff(clipNote.pitch, clipNote.trackIndex);
 
-			// Add to track
-			track.push_back(noteOn);
-			track.push_back(noteOff);
+			mTrackSet.QueueAddNote(clipNote.trackIndex, noteOn, noteOff);
 		}
+		mTrackSet.CommitTransaction();
 
 		// Separate overlapping notes (like loop recording overdub)
 		for (int trackIndex : affectedTracks)
@@ -91,7 +91,7 @@ public:
 		// Restore each affected track to its pre-paste state
 		for (const auto& snapshot : mTrackSnapshots)
 		{
-			mTrackSet.GetTrack(snapshot.trackIndex) = snapshot.originalTrack;
+			snapshot.originalTrack.AssignTo(mTrackSet.GetTrack(snapshot.trackIndex));
 		}
 	}
 
@@ -105,7 +105,7 @@ private:
 	/// Stores a complete snapshot of a track for undo purposes
 	struct TrackSnapshot {
 		int trackIndex = 0;     // Which track this snapshot is for
-		Track originalTrack;    // Complete copy of track before paste
+		CompactTrack originalTrack;   // Complete copy of track before paste
 	};
 
 	TrackSet& mTrackSet;
@@ -154,17 +154,16 @@ public:
 		{
 			TrackSnapshot snapshot;
 			snapshot.trackIndex = trackIndex;
-			snapshot.originalTrack = mTrackSet.GetTrack(trackIndex);  // Copy entire track
+			snapshot.originalTrack = CompactTrack(std::as_const(mTrackSet).GetTrack(trackIndex));  // Copy entire track
 			mTrackSnapshots.push_back(snapshot);
 		}
 
-		// Paste each clipboard note to ALL target tracks
+		// Queue each clipboard note for ALL target tracks, merged in one pass per track
+		mTrackSet.BeginTransaction();
 		for (int targetTrack : mTargetTracks)
 		{
 			for (const auto& clipNote : mClipboardNotes)
 			{
-				Track& track = mTrackSet.GetTrack(targetTrack);
-
 				// Calculate absolute tick positions
 				uint64_t noteOnTick = mPasteTick + clipNote.relativeStartTick;
 				uint64_t noteOffTick = noteOnTick + clipNote.duration;
@@ -179,11 +178,10 @@ public:
 				noteOff.tick = noteOffTick;
 				noteOff.mm = MidiMessage::NoteOff(clipNote.pitch, targetTrack);
 
-				// Add to track
-				track.push_back(noteOn);
-				track.push_back(noteOff);
+				mTrackSet.QueueAddNote(targetTrack, noteOn, noteOff);
 			}
 		}
+		mTrackSet.CommitTransaction();
 
 		// Separate overlapping notes on each target track (like loop recording overdub)
 		for (int trackIndex : mTargetTracks)
@@ -198,7 +196,7 @@ public:
 		// Restore each affected track to its pre-paste state
 		for (const auto& snapshot : mTrackSnapshots)
 		{
-			mTrackSet.GetTrack(snapshot.trackIndex) = snapshot.originalTrack;
+			snapshot.originalTrack.AssignTo(mTrackSet.GetTrack(snapshot.trackIndex));
 		}
 	}
 
@@ -216,7 +214,7 @@ private:
 	/// Stores a complete snapshot of a track for undo purposes
 	struct TrackSnapshot {
 		int trackIndex = 0;     // Which track this snapshot is for
-		Track originalTrack;    // Complete copy of track before paste
+		CompactTrack originalTrack;   // Complete copy of track before paste
 	};
 
 	TrackSet& mTrackSet;
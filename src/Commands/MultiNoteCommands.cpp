@@ -11,57 +11,31 @@
 
 void DeleteMultipleNotesCommand::Execute()
 {
-	// Group notes by track with their indices
-	std::map<int, std::vector<std::pair<size_t, size_t>>> indicesByTrack; // track -> [(noteOnIndex, noteOffIndex), ...]
-	for (const auto& note : mNotesToDelete)
+	// Queue every removal (found by id, earlier edits may have shifted indices), one merge per track
+	mTrackSet.BeginTransaction();
+	for (auto& note : mNotesToDelete)
 	{
-		indicesByTrack[note.trackIndex].push_back({note.noteOnIndex, note.noteOffIndex});
-	}
-
-	// Delete from each track
-	for (auto& [trackIndex, noteIndices] : indicesByTrack)
-	{
-		// Collect all indices to delete
-		std::vector<size_t> indicesToDelete;
-		for (const auto& [noteOnIdx, noteOffIdx] : noteIndices)
-		{
-			indicesToDelete.push_back(noteOnIdx);
-			indicesToDelete.push_back(noteOffIdx);
-		}
+		NoteLocation current = mTrackSet.ResolveNote(note);
+		if (!current.found) continue;
 
-		// Sort indices in descending order to delete from highest to lowest
-		// This ensures deleting an element doesn't affect the validity of lower indices
-		std::sort(indicesToDelete.begin(), indicesToDelete.end(),
-			[](size_t a, size_t b) { return a > b; });
-
-		Track& track = mTrackSet.GetTrack(trackIndex);
-
-		// Delete in descending index order (highest index first)
-		for (size_t idx : indicesToDelete)
-		{
-			if (idx < track.size())
-			{
-				track.erase(track.begin() + idx);
-			}
-		}
+		note = current;
+		mTrackSet.QueueRemoveNote(note);
 	}
+	mTrackSet.CommitTransaction();
 }
 
 void DeleteMultipleNotesCommand::Undo()
 {
-	// Re-add all deleted notes
-	for (const auto& note : mNotesToDelete)
+	// Re-add all deleted notes under their old ids, one merge per track
+	mTrackSet.BeginTransaction();
+	for (auto& note : mNotesToDelete)
 	{
-		Track& track = mTrackSet.GetTrack(note.trackIndex);
-		MidiMessage noteOn = MidiMessage::NoteOn(note.pitch, note.velocity, note.trackIndex);
-		MidiMessage noteOff = MidiMessage::NoteOff(note.pitch, note.trackIndex);
-		// Add both events back
-		track.emplace_back(noteOn, note.startTick);
-		track.emplace_back(noteOff, note.endTick);
+		TimedMidiEvent noteOn{MidiMessage::NoteOn(note.pitch, note.velocity, note.trackIndex), note.startTick};
+		TimedMidiEvent noteOff{MidiMessage::NoteOff(note.pitch, note.trackIndex), note.endTick};
 
-		// Re-sort track to maintain chronological order
-		TrackSet::SortTrack(track);
+		note.id = mTrackSet.QueueAddNote(note.trackIndex, noteOn, noteOff, note.id);
 	}
+	mTrackSet.CommitTransaction();
 }
 
 std::string DeleteMultipleNotesCommand::GetDescription() const
@@ -77,10 +51,10 @@ std::string DeleteMultipleNotesCommand::GetDescription() const
 void MoveMultipleNotesCommand::Execute()
 {
 	// Move each note by the specified delta
+	std::vector<TrackSet::NoteMove> moves;
+	moves.reserve(mNotesToMove.size());
 	for (const auto& noteInfo : mNotesToMove)
 	{
-		Track& track = mTrackSet.GetTrack(noteInfo.trackIndex);
-
 		// Calculate new position with delta (clamp to valid ranges)
 		int64_t newTickSigned = static_cast<int64_t>(noteInfo.startTick) + mTickDelta;
 		uint64_t newTick = (newTickSigned < 0) ? 0 : static_cast<uint64_t>(newTickSigned);
@@ -88,88 +62,32 @@ void MoveMultipleNotesCommand::Execute()
 		int newPitchSigned = static_cast<int>(noteInfo.pitch) + mPitchDelta;
 		ubyte newPitch = std::clamp(newPitchSigned, 0, MidiConstants::MAX_MIDI_NOTE);
 
-		// Update note-on event
-		if (noteInfo.noteOnIndex < track.size())
-		{
-			track[noteInfo.noteOnIndex].tick = newTick;
-			track[noteInfo.noteOnIndex].mm.mData[1] = newPitch;  // Set pitch
-		}
-
-		// Update note-off event (maintain duration)
-		if (noteInfo.noteOffIndex < track.size())
-		{
-			track[noteInfo.noteOffIndex].tick = newTick + noteInfo.GetDuration();
-			track[noteInfo.noteOffIndex].mm.mData[1] = newPitch;  // Set pitch
-		}
-	}
-
-	// Re-sort all affected tracks to maintain chronological order
-	std::set<int> affectedTracks;
-	for (const auto& noteInfo : mNotesToMove)
-	{
-		affectedTracks.insert(noteInfo.trackIndex);
+		// Note-off keeps the duration
+		moves.push_back({noteInfo, newTick, newTick + noteInfo.GetDuration(), newPitch});
 	}
 
-	for (int trackIndex : affectedTracks)
-	{
-		Track& track = mTrackSet.GetTrack(trackIndex);
-		TrackSet::SortTrack(track);
-	}
+	// One merge per affected track, moved notes keep their ids
+	mMovedNotes = mTrackSet.MoveNotes(moves);
 }
 
 void MoveMultipleNotesCommand::Undo()
 {
-	// Restore original positions for all moved notes
-	for (const auto& noteInfo : mNotesToMove)
-	{
-		Track& track = mTrackSet.GetTrack(noteInfo.trackIndex);
-
-		// Calculate where the notes ended up after the move
-		int64_t newTickSigned = static_cast<int64_t>(noteInfo.startTick) + mTickDelta;
-		uint64_t newTick = (newTickSigned < 0) ? 0 : static_cast<uint64_t>(newTickSigned);
-
-		int newPitchSigned = static_cast<int>(noteInfo.pitch) + mPitchDelta;
-		ubyte newPitch = std::clamp(newPitchSigned, 0, MidiConstants::MAX_MIDI_NOTE);
-
-		// Search for note-on with new position and restore original values
-		for (size_t i = 0; i < track.size(); i++)
-		{
-			if (track[i].tick == newTick &&
-				track[i].mm.isNoteOn() &&
-				track[i].mm.getPitch() == newPitch)
-			{
-				track[i].tick = noteInfo.startTick;
-				track[i].mm.mData[1] = noteInfo.pitch;
-				break;
-			}
-		}
-
-		// Search for note-off with new position and restore original values
-		uint64_t newEndTick = newTick + noteInfo.GetDuration();
-		for (size_t i = 0; i < track.size(); i++)
-		{
-			if (track[i].tick == newEndTick &&
-				!track[i].mm.isNoteOn() &&
-				track[i].mm.getPitch() == newPitch)
-			{
-				track[i].tick = noteInfo.startTick + noteInfo.GetDuration();
-				track[i].mm.mData[1] = noteInfo.pitch;
-				break;
-			}
-		}
-	}
-
-	// Re-sort all affected tracks to maintain chronological order
-	std::set<int> affectedTracks;
-	for (const auto& noteInfo : mNotesToMove)
+	// Move every note back to its original position, found by id instead of searching the track
+	std::vector<TrackSet::NoteMove> moves;
+	moves.reserve(mMovedNotes.size());
+	for (size_t i = 0; i < mMovedNotes.size(); i++)
 	{
-		affectedTracks.insert(noteInfo.trackIndex);
+		const NoteLocation& original = mNotesToMove[i];
+		moves.push_back({mMovedNotes[i], original.startTick, original.endTick, original.pitch});
 	}
 
-	for (int trackIndex : affectedTracks)
+	std::vector<NoteLocation> restored = mTrackSet.MoveNotes(moves);
+	for (size_t i = 0; i < restored.size(); i++)
 	{
-		Track& track = mTrackSet.GetTrack(trackIndex);
-		TrackSet::SortTrack(track);
+		if (restored[i].found)
+		{
+			mNotesToMove[i] = restored[i];  // Fresh indices for redo
+		}
 	}
 }
 
@@ -186,30 +104,32 @@ std::string MoveMultipleNotesCommand::GetDescription() const
 void QuantizeMultipleNotesCommand::Execute()
 {
 	// Quantize each note using duration-aware algorithm
+	std::vector<TrackSet::NoteMove> moves;
+	moves.reserve(mNotesToQuantize.size());
 	for (const auto& noteInfo : mNotesToQuantize)
 	{
-		Track& track = mTrackSet.GetTrack(noteInfo.trackIndex);
-
 		// Calculate duration and quantized start
 		uint64_t duration = noteInfo.GetDuration();
 		uint64_t quantizedStart = MidiConstants::RoundToGrid(noteInfo.startTick, mGridSize);
 
 		// Apply duration-aware quantization
+		uint64_t quantizedEnd;
 		if (duration < mGridSize)
 		{
 			// Short note (grace note/ornament): quantize start, extend to one grid snap
-			track[noteInfo.noteOnIndex].tick = quantizedStart;
-			track[noteInfo.noteOffIndex].tick = quantizedStart + mGridSize - MidiConstants::NOTE_SEPARATION_TICKS;
+			quantizedEnd = quantizedStart + mGridSize - MidiConstants::NOTE_SEPARATION_TICKS;
 		}
 		else
 		{
 			// Long note: quantize both start and end independently
-			track[noteInfo.noteOnIndex].tick = quantizedStart;
-			track[noteInfo.noteOffIndex].tick = MidiConstants::RoundToGrid(noteInfo.endTick, mGridSize) - MidiConstants::NOTE_SEPARATION_TICKS;
+			quantizedEnd = MidiConstants::RoundToGrid(noteInfo.endTick, mGridSize) - MidiConstants::NOTE_SEPARATION_TICKS;
 		}
+		moves.push_back({noteInfo, quantizedStart, quantizedEnd, noteInfo.pitch});
 	}
 
-	// Re-sort all affected tracks to maintain chronological order
+	mQuantizedNotes = mTrackSet.MoveNotes(moves);
+
+	// Separate notes that now overlap (keeps ids, only note-offs move)
 	std::set<int> affectedTracks;
 	for (const auto& noteInfo : mNotesToQuantize)
 	{
@@ -220,41 +140,27 @@ void QuantizeMultipleNotesCommand::Execute()
 	{
 		Track& track = mTrackSet.GetTrack(trackIndex);
 		TrackSet::SeparateOverlappingNotes(track);
-		TrackSet::SortTrack(track);
 	}
 }
 
 void QuantizeMultipleNotesCommand::Undo()
 {
-	// Restore original tick values for all quantized notes
-	for (const auto& noteInfo : mNotesToQuantize)
+	// Restore original tick values for all quantized notes, found by id
+	std::vector<TrackSet::NoteMove> moves;
+	moves.reserve(mQuantizedNotes.size());
+	for (size_t i = 0; i < mQuantizedNotes.size(); i++)
 	{
-		Track& track = mTrackSet.GetTrack(noteInfo.trackIndex);
-
-		// Restore note-on tick
-		if (noteInfo.noteOnIndex < track.size())
-		{
-			track[noteInfo.noteOnIndex].tick = noteInfo.startTick;
-		}
-
-		// Restore note-off tick
-		if (noteInfo.noteOffIndex < track.size())
-		{
-			track[noteInfo.noteOffIndex].tick = noteInfo.endTick;
-		}
+		const NoteLocation& original = mNotesToQuantize[i];
+		moves.push_back({mQuantizedNotes[i], original.startTick, original.endTick, original.pitch});
 	}
 
-	// Re-sort all affected tracks to maintain chronological order
-	std::set<int> affectedTracks;
-	for (const auto& noteInfo : mNotesToQuantize)
+	std::vector<NoteLocation> restored = mTrackSet.MoveNotes(moves);
+	for (size_t i = 0; i < restored.size(); i++)
 	{
-		affectedTracks.insert(noteInfo.trackIndex);
-	}
-
-	for (int trackIndex : affectedTracks)
-	{
-		Track& track = mTrackSet.GetTrack(trackIndex);
-		TrackSet::SortTrack(track);
+		if (restored[i].found)
+		{
+			mNotesToQuantize[i] = restored[i];  // Fresh indices for redo
+		}
 	}
 }
 
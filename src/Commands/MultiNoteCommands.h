@@ -14,7 +14,7 @@ using namespace MidiInterface;
 ///
 /// Responsibilities:
 /// - Handle batch deletion efficiently
-/// - Maintain undo capability for all deleted notes
+/// - Maintain undo capability for all deleted notes (restored under their ids)
 ///
 /// Usage:
 ///   auto cmd = std::make_unique<DeleteMultipleNotesCommand>(trackSet, notesToDelete);
@@ -43,7 +43,7 @@ private:
 ///
 /// Responsibilities:
 /// - Apply tick and pitch deltas to multiple notes
-/// - Store original positions for undo
+/// - Store original positions for undo, find moved notes again by id
 ///
 /// Usage:
 ///   auto cmd = std::make_unique<MoveMultipleNotesCommand>(trackSet, notesToMove, tickDelta, pitchDelta);
@@ -70,7 +70,8 @@ public:
 
 private:
 	TrackSet& mTrackSet;
-	std::vector<NoteLocation> mNotesToMove;
+	std::vector<NoteLocation> mNotesToMove;  // Original positions, refreshed on undo
+	std::vector<NoteLocation> mMovedNotes;   // Same notes after the move (same ids)
 	int64_t mTickDelta;  // Tick offset to apply to all notes
 	int mPitchDelta;     // Pitch offset to apply to all notes
 };
@@ -105,6 +106,7 @@ public:
 
 private:
 	TrackSet& mTrackSet;
-	std::vector<NoteLocation> mNotesToQuantize;
+	std::vector<NoteLocation> mNotesToQuantize;  // Original positions, refreshed on undo
+	std::vector<NoteLocation> mQuantizedNotes;   // Same notes after quantizing (same ids)
 	uint64_t mGridSize;  // Grid size for quantization
 };
@@ -18,8 +18,6 @@ void AddNoteCommand::Execute()
 
 	for (int targetTrack : mTargetTracks)
 	{
-		Track& track = mTrackSet.GetTrack(targetTrack);
-
 		// Create note on event (use target track's channel)
 		TimedMidiEvent noteOn;
 		noteOn.tick = mStartTick;
@@ -30,41 +28,21 @@ void AddNoteCommand::Execute()
 		noteOff.tick = noteOffTick;
 		noteOff.mm = MidiMessage::NoteOff(mPitch, targetTrack);
 
-		// Add to track
-		track.push_back(noteOn);
-		track.push_back(noteOff);
-
-		// Sort track to maintain chronological order
-		TrackSet::SortTrack(track);
-
-		// Find and store note location for undo
-		uint64_t noteOffTick = mStartTick + mDuration - MidiConstants::NOTE_SEPARATION_TICKS;
-		NoteLocation found = mTrackSet.FindNoteInTrack(targetTrack, mStartTick, noteOffTick, mPitch);
-		if (found.found)
+		// Insert in chronological order and store note location for undo
+		NoteLocation added = mTrackSet.AddNote(targetTrack, noteOn, noteOff);
+		if (added.found)
 		{
-			mAddedNotes.push_back(found);
+			mAddedNotes.push_back(added);
 		}
 	}
 }
 
 void AddNoteCommand::Undo()
 {
-	// Remove notes from each track (reverse order to handle indices correctly)
+	// Remove notes from each track (reverse order of insertion)
 	for (auto it = mAddedNotes.rbegin(); it != mAddedNotes.rend(); ++it)
 	{
-		Track& track = mTrackSet.GetTrack(it->trackIndex);
-
-		// Remove note-off first (higher index) to avoid invalidating note-on index
-		if (it->noteOffIndex < track.size())
-		{
-			track.erase(track.begin() + it->noteOffIndex);
-		}
-
-		// Remove note-on
-		if (it->noteOnIndex < track.size())
-		{
-			track.erase(track.begin() + it->noteOnIndex);
-		}
+		mTrackSet.RemoveNote(*it);
 	}
 }
 
@@ -84,27 +62,15 @@ std::string AddNoteCommand::GetDescription() const
 //==============================================================================
 void DeleteNoteCommand::Execute()
 {
-	// Delete note-off first (higher index) to avoid invalidating note-on index
-	if (mNoteOffIndex < mTrack.size())
-	{
-		mTrack.erase(mTrack.begin() + mNoteOffIndex);
-	}
-
-	// Delete note-on
-	if (mNoteOnIndex < mTrack.size())
-	{
-		mTrack.erase(mTrack.begin() + mNoteOnIndex);
-	}
+	mTrackSet.RemoveNote(mNote);
 }
 
 void DeleteNoteCommand::Undo()
 {
-	// Re-add the deleted notes
-	mTrack.push_back(mNoteOn);
-	mTrack.push_back(mNoteOff);
+	if (mNote.trackIndex < 0) return;
 
-	// Re-sort to maintain chronological order
-	TrackSet::SortTrack(mTrack);
+	// Re-add the deleted note in chronological order, under its old id
+	mNote = mTrackSet.AddNote(mNote.trackIndex, mNoteOn, mNoteOff, mNote.id);
 }
 
 std::string DeleteNoteCommand::GetDescription() const
@@ -118,45 +84,14 @@ std::string DeleteNoteCommand::GetDescription() const
 //==============================================================================
 void MoveNoteCommand::Execute()
 {
-	// Update note-on position
-	if (mNoteOnIndex < mTrack.size())
-	{
-		mTrack[mNoteOnIndex].tick = mNewTick;
-		mTrack[mNoteOnIndex].mm.mData[1] = mNewPitch;  // Pitch
-	}
-
-	// Update note-off position (maintain duration)
-	if (mNoteOffIndex < mTrack.size())
-	{
-		mTrack[mNoteOffIndex].tick = mNewTick + mNoteDuration;
-		mTrack[mNoteOffIndex].mm.mData[1] = mNewPitch;  // Pitch
-	}
-
-	// Re-sort track after moving
-	TrackSet::SortTrack(mTrack);
+	// Move note-on and note-off together (maintain duration)
+	mNote = mTrackSet.MoveNote(mNote, mNewTick, mNewTick + mNoteDuration, mNewPitch);
 }
 
 void MoveNoteCommand::Undo()
 {
-	// Find the notes again (indices may have changed after sorting)
-	size_t noteOnIdx = FindNoteIndex(mNewTick, mNewPitch, MidiEvent::NOTE_ON);
-	size_t noteOffIdx = FindNoteIndex(mNewTick + mNoteDuration, mNewPitch, MidiEvent::NOTE_OFF);
-
 	// Restore original position
-	if (noteOnIdx < mTrack.size())
-	{
-		mTrack[noteOnIdx].tick = mOldTick;
-		mTrack[noteOnIdx].mm.mData[1] = mOldPitch;
-	}
-
-	if (noteOffIdx < mTrack.size())
-	{
-		mTrack[noteOffIdx].tick = mOldTick + mNoteDuration;
-		mTrack[noteOffIdx].mm.mData[1] = mOldPitch;
-	}
-
-	// Re-sort track
-	TrackSet::SortTrack(mTrack);
+	mNote = mTrackSet.MoveNote(mNote, mOldTick, mOldTick + mNoteDuration, mOldPitch);
 }
 
 std::string MoveNoteCommand::GetDescription() const
@@ -165,48 +100,19 @@ std::string MoveNoteCommand::GetDescription() const
 	       " to " + std::to_string(mNewPitch) + ")";
 }
 
-size_t MoveNoteCommand::FindNoteIndex(uint64_t tick, uint8_t pitch, MidiEvent eventType)
-{
-	for (size_t i = 0; i < mTrack.size(); i++)
-	{
-		if (mTrack[i].tick == tick &&
-			mTrack[i].mm.mData[1] == pitch &&
-			mTrack[i].mm.getEventType() == eventType)
-		{
-			return i;
-		}
-	}
-	return mTrack.size();  // Not found
-}
-
 //==============================================================================
 // ResizeNoteCommand Implementation
 //==============================================================================
 void ResizeNoteCommand::Execute()
 {
-	// Update note-off tick to reflect new duration
-	if (mNoteOffIndex < mTrack.size())
-	{
-		mTrack[mNoteOffIndex].tick = mNoteOnTick + mNewDuration;
-	}
-
-	// Re-sort track (note-off might have moved)
-	TrackSet::SortTrack(mTrack);
+	// Move note-off to reflect new duration
+	mNote = mTrackSet.MoveNote(mNote, mNoteOnTick, mNoteOnTick + mNewDuration, mPitch);
 }
 
 void ResizeNoteCommand::Undo()
 {
-	// Find note-off again (index may have changed)
-	size_t noteOffIdx = FindNoteIndex(mNoteOnTick + mNewDuration, mPitch, MidiEvent::NOTE_OFF);
-
 	// Restore original duration
-	if (noteOffIdx < mTrack.size())
-	{
-		mTrack[noteOffIdx].tick = mNoteOnTick + mOldDuration;
-	}
-
-	// Re-sort track
-	TrackSet::SortTrack(mTrack);
+	mNote = mTrackSet.MoveNote(mNote, mNoteOnTick, mNoteOnTick + mOldDuration, mPitch);
 }
 
 std::string ResizeNoteCommand::GetDescription() const
@@ -215,37 +121,17 @@ std::string ResizeNoteCommand::GetDescription() const
 	       ", Duration: " + std::to_string(mOldDuration) + " -> " + std::to_string(mNewDuration) + ")";
 }
 
-size_t ResizeNoteCommand::FindNoteIndex(uint64_t tick, uint8_t pitch, MidiEvent eventType)
-{
-	for (size_t i = 0; i < mTrack.size(); i++)
-	{
-		if (mTrack[i].tick == tick &&
-			mTrack[i].mm.mData[1] == pitch &&
-			mTrack[i].mm.getEventType() == eventType)
-		{
-			return i;
-		}
-	}
-	return mTrack.size();  // Not found
-}
-
 //==============================================================================
 // EditNoteVelocityCommand Implementation
 //==============================================================================
 void EditNoteVelocityCommand::Execute()
 {
-	if (mNoteOnIndex < mTrack.size())
-	{
-		mTrack[mNoteOnIndex].mm.mData[2] = mNewVelocity;  // Set velocity
-	}
+	mTrackSet.SetNoteVelocity(mNote, mNewVelocity);
 }
 
 void EditNoteVelocityCommand::Undo()
 {
-	if (mNoteOnIndex < mTrack.size())
-	{
-		mTrack[mNoteOnIndex].mm.mData[2] = mOldVelocity;  // Restore velocity
-	}
+	mTrackSet.SetNoteVelocity(mNote, mOldVelocity);  // Restore velocity
 }
 
 std::string EditNoteVelocityCommand::GetDescription() const
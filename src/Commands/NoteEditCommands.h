@@ -4,6 +4,7 @@
 #include "AppModel/TrackSet/TrackSet.h"
 #include <algorithm>
 #include <cstdint>
+#include <utility>
 using namespace MidiInterface;
 
 // Single-Note Edit Commands
@@ -53,17 +54,22 @@ private:
 /// - Store deleted note data for undo
 ///
 /// Usage:
-///   auto cmd = std::make_unique<DeleteNoteCommand>(track, noteOnIndex, noteOffIndex);
+///   auto cmd = std::make_unique<DeleteNoteCommand>(trackSet, note);
 ///   appModel.ExecuteCommand(std::move(cmd));
 class DeleteNoteCommand : public Command
 {
 public:
-	DeleteNoteCommand(Track& track, size_t noteOnIndex, size_t noteOffIndex)
-		: mTrack(track), mNoteOnIndex(noteOnIndex), mNoteOffIndex(noteOffIndex)
+	DeleteNoteCommand(TrackSet& trackSet, const NoteLocation& note)
+		: mTrackSet(trackSet), mNote(note)
 	{
 		// Store the events before deleting
-		mNoteOn = mTrack[noteOnIndex];
-		mNoteOff = mTrack[noteOffIndex];
+		mNote = mTrackSet.ResolveNote(note);
+		if (mNote.found)
+		{
+			const Track& track = std::as_const(mTrackSet).GetTrack(mNote.trackIndex);
+			mNoteOn = track[mNote.noteOnIndex];
+			mNoteOff = track[mNote.noteOffIndex];
+		}
 	}
 
 	void Execute() override;
@@ -71,9 +77,8 @@ public:
 	std::string GetDescription() const override;
 
 private:
-	Track& mTrack;
-	size_t mNoteOnIndex;
-	size_t mNoteOffIndex;
+	TrackSet& mTrackSet;
+	NoteLocation mNote;  // Updated on undo, the note is re-inserted with its id at new indices
 	TimedMidiEvent mNoteOn;
 	TimedMidiEvent mNoteOff;
 };
@@ -86,20 +91,18 @@ private:
 /// - Maintain note duration
 ///
 /// Usage:
-///   auto cmd = std::make_unique<MoveNoteCommand>(track, noteOnIndex, noteOffIndex, newTick, newPitch);
+///   auto cmd = std::make_unique<MoveNoteCommand>(trackSet, note, newTick, newPitch);
 ///   appModel.ExecuteCommand(std::move(cmd));
 class MoveNoteCommand : public Command
 {
 public:
-	MoveNoteCommand(Track& track, size_t noteOnIndex, size_t noteOffIndex,
-		uint64_t newTick, uint8_t newPitch)
-		: mTrack(track), mNoteOnIndex(noteOnIndex), mNoteOffIndex(noteOffIndex),
-		mNewTick(newTick), mNewPitch(newPitch)
+	MoveNoteCommand(TrackSet& trackSet, const NoteLocation& note, uint64_t newTick, uint8_t newPitch)
+		: mTrackSet(trackSet), mNote(note), mNewTick(newTick), mNewPitch(newPitch)
 	{
 		// Store original values
-		mOldTick = mTrack[noteOnIndex].tick;
-		mOldPitch = mTrack[noteOnIndex].mm.mData[1];
-		mNoteDuration = mTrack[noteOffIndex].tick - mTrack[noteOnIndex].tick;
+		mOldTick = note.startTick;
+		mOldPitch = note.pitch;
+		mNoteDuration = note.GetDuration();
 	}
 
 	void Execute() override;
@@ -107,16 +110,13 @@ public:
 	std::string GetDescription() const override;
 
 private:
-	Track& mTrack;
-	size_t mNoteOnIndex;
-	size_t mNoteOffIndex;
+	TrackSet& mTrackSet;
+	NoteLocation mNote;  // Current location of the note (before Execute, after Undo)
 	uint64_t mOldTick;
 	uint64_t mNewTick;
 	uint8_t mOldPitch;
 	uint8_t mNewPitch;
 	uint64_t mNoteDuration;
-
-	size_t FindNoteIndex(uint64_t tick, uint8_t pitch, MidiEvent eventType);
 };
 
 /// Resizes a note (changes its duration).
@@ -126,19 +126,18 @@ private:
 /// - Store old and new durations for undo/redo
 ///
 /// Usage:
-///   auto cmd = std::make_unique<ResizeNoteCommand>(track, noteOnIndex, noteOffIndex, newDuration);
+///   auto cmd = std::make_unique<ResizeNoteCommand>(trackSet, note, newDuration);
 ///   appModel.ExecuteCommand(std::move(cmd));
 class ResizeNoteCommand : public Command
 {
 public:
-	ResizeNoteCommand(Track& track, size_t noteOnIndex, size_t noteOffIndex, uint64_t newDuration)
-		: mTrack(track), mNoteOnIndex(noteOnIndex), mNoteOffIndex(noteOffIndex),
-		mNewDuration(newDuration)
+	ResizeNoteCommand(TrackSet& trackSet, const NoteLocation& note, uint64_t newDuration)
+		: mTrackSet(trackSet), mNote(note), mNewDuration(newDuration)
 	{
 		// Store original duration
-		mOldDuration = mTrack[noteOffIndex].tick - mTrack[noteOnIndex].tick;
-		mNoteOnTick = mTrack[noteOnIndex].tick;
-		mPitch = mTrack[noteOnIndex].mm.mData[1];
+		mOldDuration = note.GetDuration();
+		mNoteOnTick = note.startTick;
+		mPitch = note.pitch;
 	}
 
 	void Execute() override;
@@ -146,15 +145,12 @@ public:
 	std::string GetDescription() const override;
 
 private:
-	Track& mTrack;
-	size_t mNoteOnIndex;
-	size_t mNoteOffIndex;
+	TrackSet& mTrackSet;
+	NoteLocation mNote;  // Current location of the note (before Execute, after Undo)
 	uint64_t mOldDuration;
 	uint64_t mNewDuration;
 	uint64_t mNoteOnTick;
 	uint8_t mPitch;
-
-	size_t FindNoteIndex(uint64_t tick, uint8_t pitch, MidiEvent eventType);
 };
 
 /// Edits a note's velocity.
@@ -164,19 +160,16 @@ private:
 /// - Store old and new velocities for undo/redo
 ///
 /// Usage:
-///   auto cmd = std::make_unique<EditNoteVelocityCommand>(track, noteOnIndex, newVelocity);
+///   auto cmd = std::make_unique<EditNoteVelocityCommand>(trackSet, note, newVelocity);
 ///   appModel.ExecuteCommand(std::move(cmd));
 class EditNoteVelocityCommand : public Command
 {
 public:
-	EditNoteVelocityCommand(Track& track, size_t noteOnIndex, ubyte newVelocity)
-		: mTrack(track), mNoteOnIndex(noteOnIndex), mNewVelocity(newVelocity)
+	EditNoteVelocityCommand(TrackSet& trackSet, const NoteLocation& note, ubyte newVelocity)
+		: mTrackSet(trackSet), mNote(note), mNewVelocity(newVelocity)
 	{
 		// Store original velocity
-		if (mNoteOnIndex < mTrack.size())
-		{
-			mOldVelocity = mTrack[mNoteOnIndex].mm.getVelocity();
-		}
+		mOldVelocity = note.velocity;
 	}
 
 	void Execute() override;
@@ -184,8 +177,8 @@ public:
 	std::string GetDescription() const override;
 
 private:
-	Track& mTrack;
-	size_t mNoteOnIndex;
+	TrackSet& mTrackSet;
+	NoteLocation mNote;
 	ubyte mOldVelocity = 0;
 	ubyte mNewVelocity = 0;
 };
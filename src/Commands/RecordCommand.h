@@ -2,7 +2,7 @@
 #pragma once
 #include "Command.h"
 #include "AppModel/TrackSet/TrackSet.h"
-#include <algorithm>
+#include "AppModel/TrackSet/CompactTrack.h"
 #include <vector>
 using namespace MidiInterface;
 
@@ -32,51 +32,38 @@ public:
 
 	void Execute() override
 	{
-		// Add all recorded notes to their respective tracks
-		for (const auto& event : mRecordedNotes)
+		// Queue all recorded notes for their respective tracks, only touched tracks get merged
+		mTrackSet.BeginTransaction();
+		mRecordedNotes.ForEach([this](const TimedMidiEvent& event)
 		{
 			ubyte channel = event.mm.getChannel();
-			mTrackSet.GetTrack(channel).push_back(event);
-		}
-
-		// Sort all affected tracks by tick to maintain chronological order
-		for (int i = 0; i < 15; i++)
-		{
-			auto& track = mTrackSet.GetTrack(i);
-			TrackSet::SortTrack(track);
-		}
+			mTrackSet.QueueInsert(channel, event);
+		});
+		mTrackSet.CommitTransaction();
 	}
 
 	void Undo() override
 	{
-		// Remove all recorded notes from their respective tracks
-		for (const auto& event : mRecordedNotes)
+		// Remove all recorded notes from their respective tracks, matched by tick and MIDI data
+		// in one merge pass per touched track
+		mTrackSet.BeginTransaction();
+		mRecordedNotes.ForEach([this](const TimedMidiEvent& event)
 		{
 			ubyte channel = event.mm.getChannel();
 
 			// Skip if channel is out of bounds (should not happen, but safety check)
-			if (channel >= 15) continue;
-
-			auto& track = mTrackSet.GetTrack(channel);
-
-			// Find and remove this event by matching tick and MIDI data
-			auto it = std::remove_if(track.begin(), track.end(),
-				[&](const TimedMidiEvent& e) {
-					return e.tick == event.tick &&
-						   e.mm.mData[0] == event.mm.mData[0] &&
-						   e.mm.mData[1] == event.mm.mData[1] &&
-						   e.mm.mData[2] == event.mm.mData[2];
-				});
+			if (channel >= 15) return;
 
-			track.erase(it, track.end());
-		}
+			mTrackSet.QueueRemoveEvent(channel, event);
+		});
+		mTrackSet.CommitTransaction();
 	}
 
 	std::string GetDescription() const override
 	{
 		// Count note-on events (each note-on represents one note played)
 		int noteCount = 0;
-		for (const auto& event : mRecordedNotes)
+		mRecordedNotes.ForEach([&noteCount](const TimedMidiEvent& event)
 		{
 			// Note-on messages have status byte 144-159 (0x90-0x9F)
 			ubyte status = event.mm.mData[0] & 0xF0;
@@ -84,12 +71,12 @@ public:
 			{
 				noteCount++;
 			}
-		}
+		});
 
 		return "Record " + std::to_string(noteCount) + " note" + (noteCount != 1 ? "s" : "");
 	}
 
 private:
 	TrackSet& mTrackSet;
-	Track mRecordedNotes;  // Copy of all recorded notes for undo purposes
+	CompactTrack mRecordedNotes;  // Copy of all recorded notes for undo purposes (8 bytes per event)
 };
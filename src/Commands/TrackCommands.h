@@ -2,10 +2,12 @@
 #pragma once
 #include "Command.h"
 #include "AppModel/TrackSet/TrackSet.h"
+#include "AppModel/TrackSet/CompactTrack.h"
 #include "MidiConstants.h"
 #include <algorithm>
 #include <vector>
 #include <string>
+#include <utility>
 using namespace MidiInterface;
 
 // Track-Level Commands
@@ -17,32 +19,34 @@ using namespace MidiInterface;
 /// - Store complete backup for undo
 ///
 /// Usage:
-///   auto cmd = std::make_unique<ClearTrackCommand>(track, trackNumber);
+///   auto cmd = std::make_unique<ClearTrackCommand>(trackSet, trackNumber);
 ///   appModel.ExecuteCommand(std::move(cmd));
 class ClearTrackCommand : public Command
 {
 public:
 	/// Construct a clear track command
-	/// @param trackNumber Track number for display purposes
-	ClearTrackCommand(Track& track, int trackNumber)
-		: mTrack(track)
+	/// @param trackNumber Track to clear, also used for display purposes
+	ClearTrackCommand(TrackSet& trackSet, int trackNumber)
+		: mTrackSet(trackSet)
 		, mTrackNumber(trackNumber)
 	{
 	}
 
 	void Execute() override
 	{
+		Track& track = mTrackSet.GetTrack(mTrackNumber);
+
 		// Backup all events before clearing
-		mBackup = mTrack;
+		mBackup = CompactTrack(track);
 
 		// Clear the track
-		mTrack.clear();
+		track.clear();
 	}
 
 	void Undo() override
 	{
 		// Restore backed-up events
-		mTrack = mBackup;
+		mBackup.AssignTo(mTrackSet.GetTrack(mTrackNumber));
 	}
 
 	std::string GetDescription() const override
@@ -51,9 +55,9 @@ public:
 	}
 
 private:
-	Track& mTrack;          // Reference to the track to clear
-	int mTrackNumber;       // Track number for description
-	Track mBackup;          // Backup storage for undo
+	TrackSet& mTrackSet;    // Reference to the TrackSet
+	int mTrackNumber;       // Track to clear, also used for description
+	CompactTrack mBackup;   // Backup storage for undo
 };
 
 /// Quantizes all non-empty tracks in the TrackSet.
@@ -75,20 +79,16 @@ public:
 		: mTrackSet(trackSet)
 		, mGridSize(gridSize)
 	{
-		// Store original ticks for all non-empty tracks
+		// Store original events for all non-empty tracks
 		for (int i = 0; i < MidiConstants::CHANNEL_COUNT; i++)
 		{
-			Track& track = mTrackSet.GetTrack(i);
+			const Track& track = std::as_const(mTrackSet).GetTrack(i);
 			if (!track.empty())
 			{
 				TrackBackup backup;
 				backup.trackIndex = i;
-				backup.originalTicks.reserve(track.size());
-				for (const auto& event : track)
-				{
-					backup.originalTicks.push_back(event.tick);
-				}
-				mTrackBackups.push_back(backup);
+				backup.originalTrack = CompactTrack(track);
+				mTrackBackups.push_back(std::move(backup));
 			}
 		}
 	}
@@ -105,25 +105,11 @@ public:
 
 	void Undo() override
 	{
-		// Restore original ticks for all backed-up tracks
+		// Restore the pre-quantize events for all backed-up tracks
+		// (quantizing re-sorts, so ticks cannot be restored by position)
 		for (const auto& backup : mTrackBackups)
 		{
-			Track& track = mTrackSet.GetTrack(backup.trackIndex);
-
-			// Safety check - track size changed, cannot undo safely
-			if (backup.originalTicks.size() != track.size())
-			{
-				continue;
-			}
-
-			// Restore ticks
-			for (size_t i = 0; i < track.size(); i++)
-			{
-				track[i].tick = backup.originalTicks[i];
-			}
-
-			// Re-sort track
-			TrackSet::SortTrack(track);
+			backup.originalTrack.AssignTo(mTrackSet.GetTrack(backup.trackIndex));
 		}
 	}
 
@@ -135,7 +121,7 @@ public:
 		int totalNoteCount = 0;
 		for (const auto& backup : mTrackBackups)
 		{
-			const Track& track = mTrackSet.GetTrack(backup.trackIndex);
+			const Track& track = std::as_const(mTrackSet).GetTrack(backup.trackIndex);
 			for (const auto& event : track)
 			{
 				ubyte status = event.mm.mData[0] & 0xF0;
@@ -151,11 +137,11 @@ public:
 	}
 
 private:
-	/// Backup structure for a single track's original tick values
+	/// Backup structure for a single track's original events
 	struct TrackBackup
 	{
 		int trackIndex;
-		std::vector<uint64_t> originalTicks;
+		CompactTrack originalTrack;
 	};
 
 	/// Apply quantization to a single track using shared TrackSet helper
@@ -166,7 +152,7 @@ private:
 
 	TrackSet& mTrackSet;                    // Reference to the TrackSet
 	uint64_t mGridSize;                     // Tick amount to quantize notes to
-	std::vector<TrackBackup> mTrackBackups; // Original timestamps for all tracks
+	std::vector<TrackBackup> mTrackBackups; // Original events for all tracks
 };
 
 /// Quantizes specific tracks in the TrackSet.
@@ -189,20 +175,16 @@ public:
 		: mTrackSet(trackSet)
 		, mGridSize(gridSize)
 	{
-		// Store original ticks for specified tracks
+		// Store original events for specified tracks
 		for (int trackIndex : trackIndices)
 		{
-			Track& track = mTrackSet.GetTrack(trackIndex);
+			const Track& track = std::as_const(mTrackSet).GetTrack(trackIndex);
 			if (!track.empty())
 			{
 				TrackBackup backup;
 				backup.trackIndex = trackIndex;
-				backup.originalTicks.reserve(track.size());
-				for (const auto& event : track)
-				{
-					backup.originalTicks.push_back(event.tick);
-				}
-				mTrackBackups.push_back(backup);
+				backup.originalTrack = CompactTrack(track);
+				mTrackBackups.push_back(std::move(backup));
 			}
 		}
 	}
@@ -219,25 +201,11 @@ public:
 
 	void Undo() override
 	{
-		// Restore original ticks for all backed-up tracks
+		// Restore the pre-quantize events for all backed-up tracks
+		// (quantizing re-sorts, so ticks cannot be restored by position)
 		for (const auto& backup : mTrackBackups)
 		{
-			Track& track = mTrackSet.GetTrack(backup.trackIndex);
-
-			// Safety check - track size changed, cannot undo safely
-			if (backup.originalTicks.size() != track.size())
-			{
-				continue;
-			}
-
-			// Restore ticks
-			for (size_t i = 0; i < track.size(); i++)
-			{
-				track[i].tick = backup.originalTicks[i];
-			}
-
-			// Re-sort track
-			TrackSet::SortTrack(track);
+			backup.originalTrack.AssignTo(mTrackSet.GetTrack(backup.trackIndex));
 		}
 	}
 
@@ -250,7 +218,7 @@ public:
 		int trackCount = static_cast<int>(mTrackBackups.size());
 		for (const auto& backup : mTrackBackups)
 		{
-			const Track& track = mTrackSet.GetTrack(backup.trackIndex);
+			const Track& track = std::as_const(mTrackSet).GetTrack(backup.trackIndex);
 			for (const auto& event : track)
 			{
 				ubyte status = event.mm.mData[0] & 0xF0;
@@ -267,11 +235,11 @@ public:
 	}
 
 private:
-	/// Backup structure for a single track's original tick values
+	/// Backup structure for a single track's original events
 	struct TrackBackup
 	{
 		int trackIndex;
-		std::vector<uint64_t> originalTicks;
+		CompactTrack originalTrack;
 	};
 
 	/// Apply quantization to a single track using shared TrackSet helper
@@ -282,5 +250,5 @@ private:
 
 	TrackSet& mTrackSet;                    // Reference to the TrackSet
 	uint64_t mGridSize;                     // Tick amount to quantize notes to
-	std::vector<TrackBackup> mTrackBackups; // Original timestamps for specified tracks
+	std::vector<TrackBackup> mTrackBackups; // Original events for specified tracks
 };
@@ -0,0 +1,161 @@
+// HeadlessMain.cpp
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "AppModel/ProjectManager/ProjectManager.h"
+#include "AppModel/RecordingSession/RecordingSession.h"
+#include "AppModel/Sequencer/PlaybackEngine.h"
+#include "AppModel/SoundBank/SoundBank.h"
+#include "AppModel/TrackSet/TrackSet.h"
+#include "AppModel/Transport/Transport.h"
+
+// Headless driver for MidiWorksCore: loads a project or MIDI file, plays it into a null
+// device and saves or exports it, without a window or a MIDI port.
+//
+//   MidiWorksHeadless song.mwp --play 30 --export song.mid
+//   MidiWorksHeadless song.mid --save song.mwp
+namespace
+{
+	struct Options
+	{
+		std::string input;
+		double playSeconds = 0.0;  // 0 = don't play
+		std::string exportPath;
+		std::string savePath;
+	};
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"Usage: MidiWorksHeadless <project.mwp | file.mid> [--play seconds] [--export file.mid] [--save project.mwp]\n");
+	}
+
+	bool ParseOptions(int argc, char* argv[], Options& options)
+	{
+		if (argc < 2) return false;
+		options.input = argv[1];
+
+		for (int i = 2; i < argc; i++)
+		{
+			std::string option = argv[i];
+			if (i + 1 >= argc) return false;
+
+			if (option == "--play") options.playSeconds = std::atof(argv[++i]);
+			else if (option == "--export") options.exportPath = argv[++i];
+			else if (option == "--save") options.savePath = argv[++i];
+			else return false;
+		}
+		return true;
+	}
+
+	bool EndsWith(const std::string& text, const std::string& suffix)
+	{
+		return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+
+	uint64_t GetEndTick(const TrackSet& trackSet)
+	{
+		uint64_t endTick = 0;
+		for (ubyte c = 0; c < MidiConstants::CHANNEL_COUNT; c++)
+		{
+			if (!trackSet.IsTrackEmpty(c)) endTick = std::max(endTick, trackSet.GetTrack(c).back().tick);
+		}
+		return endTick;
+	}
+
+	/// Play from tick 0 through the last event (or the time limit) with no output attached,
+	/// stepping the engine every millisecond like the sequencer thread does
+	void Play(const Transport& transport, const SoundBank& soundBank, const TrackSet& trackSet, double seconds)
+	{
+		PlaybackEngine engine;
+		engine.Post(EngineCommand{.type = EngineCommand::Type::SetTempoMap, .tempoMap = transport.GetTempoMap()});
+		engine.Post(EngineCommand{.type = EngineCommand::Type::SetLoop, .loop = transport.GetLoopSettings()});
+		engine.Post(EngineCommand{.type = EngineCommand::Type::SetChannelMask, .channelMask = soundBank.GetPlayableMask()});
+		engine.Post(EngineCommand{.type = EngineCommand::Type::SetTracks, .tracks = trackSet.GetSnapshot()});
+		engine.Post(EngineCommand{.type = EngineCommand::Type::Start, .tick = 0, .generation = 1});
+
+		using Clock = std::chrono::steady_clock;
+		const uint64_t endTick = GetEndTick(trackSet);
+		const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+		uint64_t tick = 0;
+		uint64_t steps = 0;
+		Clock::duration totalStep{};
+		Clock::duration maxStep{};
+
+		while (tick <= endTick && Clock::now() < deadline)
+		{
+			auto start = Clock::now();
+			engine.Step();
+			auto elapsed = Clock::now() - start;
+			totalStep += elapsed;
+			maxStep = std::max(maxStep, elapsed);
+			steps++;
+
+			EngineEvent event;
+			while (engine.PollEvent(event))
+			{
+				if (event.type == EngineEvent::Type::Position) tick = event.tick;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		engine.Post(EngineCommand{.type = EngineCommand::Type::Stop});
+		engine.Step();
+
+		auto us = [](Clock::duration d) { return std::chrono::duration<double, std::micro>(d).count(); };
+		std::printf("Played to tick %llu of %llu in %llu steps (step mean %.1f us, max %.1f us)\n",
+			static_cast<unsigned long long>(tick), static_cast<unsigned long long>(endTick),
+			static_cast<unsigned long long>(steps), steps ? us(totalStep) / steps : 0.0, us(maxStep));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	// No MIDI device: channel settings and previews go nowhere
+	Transport transport;
+	SoundBank soundBank(nullptr);
+	TrackSet trackSet;
+	RecordingSession recordingSession;
+	ProjectManager projectManager(transport, soundBank, trackSet, recordingSession);
+	projectManager.SetErrorCallback([](const std::string& title, const std::string& message) {
+		std::fprintf(stderr, "%s: %s\n", title.c_str(), message.c_str());
+	});
+
+	bool loaded = EndsWith(options.input, ".mid") || EndsWith(options.input, ".midi")
+		? projectManager.ImportMIDI(options.input)
+		: projectManager.LoadProject(options.input);
+	if (!loaded)
+	{
+		std::fprintf(stderr, "Could not load %s\n", options.input.c_str());
+		return 1;
+	}
+	std::printf("Loaded %s: %zu tempo/meter segments, last event at tick %llu\n", options.input.c_str(),
+		transport.GetTempoMap()->GetSegments().size(), static_cast<unsigned long long>(GetEndTick(trackSet)));
+
+	if (options.playSeconds > 0.0)
+	{
+		Play(transport, soundBank, trackSet, options.playSeconds);
+	}
+
+	if (!options.exportPath.empty() && !projectManager.ExportMIDI(options.exportPath))
+	{
+		std::fprintf(stderr, "Could not export %s\n", options.exportPath.c_str());
+		return 1;
+	}
+
+	if (!options.savePath.empty() && !projectManager.SaveProject(options.savePath))
+	{
+		std::fprintf(stderr, "Could not save %s\n", options.savePath.c_str());
+		return 1;
+	}
+	return 0;
+}
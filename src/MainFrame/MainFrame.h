@@ -13,7 +13,7 @@
 ///
 /// Responsibilities:
 /// - Create and manage all UI panels using wxAuiManager
-/// - Orchestrate update loop (10ms timer)
+/// - Orchestrate update loop (1ms model timer, playback optionally on the sequencer thread)
 /// - Handle menu events and keyboard shortcuts
 /// - Manage file operations (new, open, save, import/export)
 /// - Coordinate between panels and AppModel
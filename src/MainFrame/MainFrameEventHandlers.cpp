@@ -329,9 +329,10 @@ void MainFrame::OnClose(wxCloseEvent& event)
 		return;
 	}
 
-	// Stop the timer before destroying panels to prevent slow shutdown
+	// Stop the timers and sequencer thread before destroying panels to prevent slow shutdown
 	mModelTimer.Stop();
 	mDisplayTimer.Stop();
+	mAppModel->StopSequencerThread();
 	// Allow the window to close
 	event.Skip(); 		
 }
@@ -24,6 +24,8 @@ namespace MidiConstants
 	static constexpr int DEFAULT_TIME_SIGNATURE_DENOMINATOR = 4;
 	static constexpr int DEFAULT_VOLUME = 100;
 	static constexpr int DEFAULT_VELOCITY = 100;
+	static constexpr int DEFAULT_OUTPUT_LOOKAHEAD_MS = 20;  // How far ahead scheduled output is queued
+	static constexpr int MAX_INPUT_LATENCY_MS = 200;        // Upper bound for recording latency compensation
 
 	// Use const for non-constexpr arrays
 	const std::string NUMERATOR_LIST[] = 
@@ -4,8 +4,12 @@
 
 using MidiInterface::ubyte;
 
+/// Identifies a note for as long as it exists, independent of event indices (0 = no id)
+using NoteId = uint32_t;
+
 struct NoteLocation
 {
+	NoteId		id			 = 0;
 	bool		found		 = false;
 	int			trackIndex   = -1;
 	size_t		noteOnIndex  = 0;
@@ -16,8 +20,11 @@ struct NoteLocation
 	ubyte		velocity     = 0;
 
 	// Equality operator for finding notes in selection
+	// Compares ids when both notes have one, event indices otherwise
 	bool operator==(const NoteLocation& other) const 
 	{
+		if (id != 0 && other.id != 0)
+			return id == other.id;
 		return trackIndex == other.trackIndex &&
 		       noteOnIndex == other.noteOnIndex &&
 		       noteOffIndex == other.noteOffIndex;
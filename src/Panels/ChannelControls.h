@@ -23,7 +23,6 @@ public:
 		: wxPanel(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize)
 		, mAppModel(model)
 		, mChannel(channel)
-		, mMidiOut(mAppModel->GetSoundBank().GetMidiOutDevice())
 	{
 		CreateControls();
 		SetupSizers();
@@ -40,7 +39,7 @@ public:
 		mRecordCheck->SetValue(mChannel.record);
 
 		// Update color swatch
-		mColorSwatch->SetBackgroundColour(mChannel.customColor);
+		mColorSwatch->SetBackgroundColour(GetSwatchColour());
 		mColorSwatch->Refresh();
 
 		// Update label with custom name if set
@@ -53,7 +52,6 @@ public:
 private:
 	std::shared_ptr<AppModel> mAppModel;
 	MidiChannel& mChannel;
-	std::shared_ptr<MidiOut> mMidiOut;
 	wxStaticLine* mStaticLine;
 	wxPanel* mColorSwatch;
 	wxStaticText* mLabel;
@@ -73,7 +71,7 @@ private:
 
 		// Create color swatch - small colored square
 		mColorSwatch = new wxPanel(this, wxID_ANY, wxDefaultPosition, wxSize(15, 15));
-		mColorSwatch->SetBackgroundColour(mChannel.customColor);
+		mColorSwatch->SetBackgroundColour(GetSwatchColour());
 
 		// Use custom name if set, otherwise default "Channel N"
 		wxString strLabel = mChannel.customName.empty()
@@ -153,20 +151,26 @@ private:
 		SetSizer(mMainSizer);
 	}
 
+	wxColour GetSwatchColour() const
+	{
+		return wxColour(mChannel.customColor.red, mChannel.customColor.green, mChannel.customColor.blue);
+	}
+
 	void OnColorSwatchClicked(wxMouseEvent& event)
 	{
 		// Open color picker dialog
 		wxColourData colorData;
-		colorData.SetColour(mChannel.customColor);
+		colorData.SetColour(GetSwatchColour());
 
 		wxColourDialog dialog(this, &colorData);
 		if (dialog.ShowModal() == wxID_OK)
 		{
 			// Update channel color
-			mChannel.customColor = dialog.GetColourData().GetColour();
+			wxColour colour = dialog.GetColourData().GetColour();
+			mChannel.customColor = ChannelColor{colour.Red(), colour.Green(), colour.Blue()};
 
 			// Update swatch display
-			mColorSwatch->SetBackgroundColour(mChannel.customColor);
+			mColorSwatch->SetBackgroundColour(colour);
 			mColorSwatch->Refresh();
 		}
 	}
@@ -250,20 +254,19 @@ private:
 		SendVolume();
 	}
 
-	// @TODO: currently Mute|Solo|Record checks don't have an affect yet on playback
 	void OnMuteToggled(wxCommandEvent& event)
 	{
-		mChannel.mute = mMuteCheck->GetValue();
+		mAppModel->GetSoundBank().SetChannelMute(mChannel.channelNumber, mMuteCheck->GetValue());
 	}
 
 	void OnSoloToggled(wxCommandEvent& event)
 	{
-		mChannel.solo = mSoloCheck->GetValue();
+		mAppModel->GetSoundBank().SetChannelSolo(mChannel.channelNumber, mSoloCheck->GetValue());
 	}
 
 	void OnRecordToggled(wxCommandEvent& event)
 	{
-		mChannel.record = mRecordCheck->GetValue();
+		mAppModel->GetSoundBank().SetChannelRecord(mChannel.channelNumber, mRecordCheck->GetValue());
 	}
 
 	void OnClearButton(wxCommandEvent& event)
@@ -288,19 +291,13 @@ private:
 
 	void SendPatch()
 	{
-		if (mMidiOut)
-		{
-			auto pc = MidiMessage::ProgramChange(mChannel.programNumber, mChannel.channelNumber);
-			mMidiOut->sendMessage(pc);
-		}
+		auto pc = MidiMessage::ProgramChange(mChannel.programNumber, mChannel.channelNumber);
+		mAppModel->GetSoundBank().SendMessage(pc);
 	}
 
 	void SendVolume()
 	{
-		if (mMidiOut)
-		{
-			auto vol = MidiMessage::ControlChange(VOLUME, mChannel.volume, mChannel.channelNumber);
-			mMidiOut->sendMessage(vol);
-		}
+		auto vol = MidiMessage::ControlChange(VOLUME, mChannel.volume, mChannel.channelNumber);
+		mAppModel->GetSoundBank().SendMessage(vol);
 	}
 };
@@ -81,7 +81,7 @@ void DrumMachinePanel::RebuildGrid()
 			else
 			{
 				// Check if column lands on a measure boundary
-				uint64_t ticksPerMeasure = mTransport.GetTicksPerMeasure();
+				uint64_t ticksPerMeasure = mTransport.GetTicksPerMeasure(mTransport.GetLoopStart());
 				bool isOnMeasure = mDrumMachine.IsColumnOnMeasure(col, ticksPerMeasure);
 
 				if (isOnMeasure)
@@ -143,7 +143,7 @@ void DrumMachinePanel::RefreshPadButtonColor(size_t rowIndex, size_t columnIndex
 	else
 	{
 		// Check if column lands on a measure boundary
-		uint64_t ticksPerMeasure = mTransport.GetTicksPerMeasure();
+		uint64_t ticksPerMeasure = mTransport.GetTicksPerMeasure(mTransport.GetLoopStart());
 		bool isOnMeasure = mDrumMachine.IsColumnOnMeasure(columnIndex, ticksPerMeasure);
 
 		if (isOnMeasure)
@@ -309,7 +309,7 @@ void DrumMachinePanel::OnPadToggle(wxCommandEvent& event)
 	else
 	{
 		// Check if column lands on a measure boundary
-		uint64_t ticksPerMeasure = mTransport.GetTicksPerMeasure();
+		uint64_t ticksPerMeasure = mTransport.GetTicksPerMeasure(mTransport.GetLoopStart());
 		bool isOnMeasure = mDrumMachine.IsColumnOnMeasure(col, ticksPerMeasure);
 
 		if (isOnMeasure)
@@ -411,26 +411,18 @@ void MidiCanvasPanel::DrawGrid(wxGraphicsContext* gc)
 	int canvasWidth = GetSize().GetWidth();
 	int canvasHeight = GetSize().GetHeight();
 
-	// Dynamic grid based on time signature
-	int ticksPerBeat = mTransport.GetTicksPerBeat();
-	int ticksPerMeasure = mTransport.GetTicksPerMeasure();
-
-	// Draw vertical lines (time grid: beats and measures)
+	// Draw vertical lines (time grid: beats and measures, following time signature changes)
 	int startTick = -mOriginOffset.x * mTicksPerPixel;
 	int endTick = startTick + (canvasWidth * mTicksPerPixel);
+	const TempoMap& tempoMap = *mTransport.GetTempoMap();
 
-	// Round to nearest beat
-	startTick = (startTick / ticksPerBeat) * ticksPerBeat;
-
-	for (int tick = startTick; tick <= endTick; tick += ticksPerBeat)
+	for (auto beat = tempoMap.GetNextBeat(std::max(startTick, 0)); static_cast<int64_t>(beat.tick) <= endTick;
+		beat = tempoMap.GetNextBeat(beat.tick + 1))
 	{
-		if (tick < 0) continue;
-
-		int x = TickToScreenX(tick);
+		int x = TickToScreenX(beat.tick);
 		if (x < 0 || x > canvasWidth) continue;
 
-		bool isMeasure = (tick % ticksPerMeasure) == 0;
-		if (isMeasure)
+		if (beat.isDownbeat)
 		{
 			gc->SetPen(wxPen(GRID_MEASURE_LINE, 2));
 		}
@@ -502,15 +494,14 @@ void MidiCanvasPanel::DrawTrackNotes(wxGraphicsContext* gc)
 		if (mPreviewManager.HasNoteEditPreview())
 		{
 			const auto& preview = mPreviewManager.GetNoteEditPreview();
-			if (note.trackIndex == preview.originalNote.trackIndex &&
-			    note.noteOnIndex == preview.originalNote.noteOnIndex)
+			if (note == preview.originalNote)
 			{
 				continue;  // Skip this note, will draw preview instead
 			}
 		}
 		// Set color for this track
-		auto trackColor = mAppModel->GetSoundBank().GetChannelColor(note.trackIndex);
-		gc->SetBrush(wxBrush(trackColor));
+		ChannelColor trackColor = mAppModel->GetSoundBank().GetChannelColor(note.trackIndex);
+		gc->SetBrush(wxBrush(wxColour(trackColor.red, trackColor.green, trackColor.blue)));
 		DrawNote(gc, note);
 	}
 }
@@ -778,8 +769,7 @@ void MidiCanvasPanel::DrawVelocityEditor(wxGraphicsContext* gc)
 		// Check if this is the control being edited
 		bool isBeingEdited = (mMouseMode == MouseMode::EditingVelocity &&
 		                      mVelocityEditNote.found &&
-		                      mVelocityEditNote.trackIndex == note.trackIndex &&
-		                      mVelocityEditNote.noteOnIndex == note.noteOnIndex);
+		                      mVelocityEditNote == note);
 
 		// Use temporary velocity value if being edited, otherwise use note's velocity
 		ubyte displayVelocity = isBeingEdited ? mVelocityEditNote.velocity : note.velocity;
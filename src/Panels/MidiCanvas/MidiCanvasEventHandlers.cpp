@@ -252,9 +252,7 @@ void MidiCanvasPanel::OnMiddleDown(wxMouseEvent& event)
 		mAppModel->DeleteNote(clickedNote);
 
 		// Clear hover state if we deleted the hovered note
-		if (mHoveredNote.found &&
-		    mHoveredNote.trackIndex == clickedNote.trackIndex &&
-		    mHoveredNote.noteOnIndex == clickedNote.noteOnIndex)
+		if (mHoveredNote.found && mHoveredNote == clickedNote)
 		{
 			mHoveredNote.found = false;
 		}
@@ -460,8 +458,7 @@ void MidiCanvasPanel::OnMouseMove(wxMouseEvent& event)
 	{
 		NoteLocation newHover = FindNoteAtPosition(pos.x, pos.y);
 		if (newHover.found != mHoveredNote.found ||
-		    (newHover.found && (newHover.trackIndex != mHoveredNote.trackIndex ||
-		                        newHover.noteOnIndex != mHoveredNote.noteOnIndex)))
+		    (newHover.found && newHover != mHoveredNote))
 		{
 			mHoveredNote = newHover;
 			Refresh();
@@ -618,7 +615,7 @@ void MidiCanvasPanel::OnKeyDown(wxKeyEvent& event)
 void MidiCanvasPanel::CopySelectedNotesToClipboard()
 {
 	if (mSelection.IsEmpty()) return;
-	mAppModel->GetClipboard().CopyNotes(mSelection.GetNotes(), mTrackSet);
+	mAppModel->GetClipboard().CopyNotes(mSelection.GetNotes());
 }
 
 void MidiCanvasPanel::DeleteSelectedNotes()
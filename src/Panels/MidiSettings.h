@@ -2,6 +2,7 @@
 #pragma once
 
 #include <wx/wx.h>
+#include <wx/spinctrl.h>
 #include "AppModel/AppModel.h"
 
 /// Panel for MIDI input port selection.
@@ -9,6 +10,10 @@
 /// Responsibilities:
 /// - Display available MIDI input ports
 /// - Allow user to select active input port
+/// - Toggle the sequencer thread (playback timing independent of UI work)
+/// - Toggle scheduled output (timestamped on the ALSA sequencer, Linux only)
+/// - Set input latency compensation for recording
+/// - Toggle MIDI thru from the input callback (lowest monitoring latency)
 class MidiSettingsPanel : public wxPanel
 {
 public:
@@ -25,6 +30,10 @@ public:
 private:
 	std::shared_ptr<AppModel> mAppModel;
 	wxRadioBox* mInPortList;
+	wxCheckBox* mSequencerThreadCheck;
+	wxCheckBox* mScheduledOutputCheck;
+	wxSpinCtrl* mInputLatencySpin;
+	wxCheckBox* mCallbackThruCheck;
 
 	void CreateControls()
 	{
@@ -42,6 +51,23 @@ private:
 		mInPortList = new wxRadioBox(this, wxID_ANY, wxT("Midi In Port"),
 			wxDefaultPosition, wxDefaultSize, inPorts, 1, wxRA_SPECIFY_COLS);
 		mInPortList->SetFont(mainFont);
+
+		mSequencerThreadCheck = new wxCheckBox(this, wxID_ANY, "Run sequencer on its own thread");
+		mSequencerThreadCheck->SetFont(mainFont);
+		mSequencerThreadCheck->SetValue(mAppModel->IsSequencerThreadRunning());
+
+		mScheduledOutputCheck = new wxCheckBox(this, wxID_ANY, "Schedule output ahead (ALSA sequencer)");
+		mScheduledOutputCheck->SetFont(mainFont);
+		mScheduledOutputCheck->SetValue(mAppModel->GetOutputLookahead() > 0);
+		mScheduledOutputCheck->Enable(AlsaSeqScheduler::IsSupported());
+
+		mInputLatencySpin = new wxSpinCtrl(this, wxID_ANY, "", wxDefaultPosition, wxSize(80, -1));
+		mInputLatencySpin->SetRange(0, MidiConstants::MAX_INPUT_LATENCY_MS);
+		mInputLatencySpin->SetValue(mAppModel->GetRecordingSession().GetInputLatency());
+
+		mCallbackThruCheck = new wxCheckBox(this, wxID_ANY, "Play input directly from the MIDI callback");
+		mCallbackThruCheck->SetFont(mainFont);
+		mCallbackThruCheck->SetValue(mAppModel->GetMidiInputManager().IsThruEnabled());
 	}
 
 	void SetupSizers()
@@ -49,6 +75,16 @@ private:
 		wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
 
 		mainSizer->Add(mInPortList, wxSizerFlags().Expand());
+		mainSizer->Add(mSequencerThreadCheck, wxSizerFlags().Border(wxTOP, 10));
+		mainSizer->Add(mScheduledOutputCheck, wxSizerFlags().Border(wxTOP, 5));
+
+		wxBoxSizer* latencySizer = new wxBoxSizer(wxHORIZONTAL);
+		wxStaticText* latencyLabel = new wxStaticText(this, wxID_ANY, "Input latency (ms)");
+		latencyLabel->SetFont(wxFont(wxFontInfo(wxSize(0, 12))));
+		latencySizer->Add(latencyLabel, wxSizerFlags().CenterVertical());
+		latencySizer->Add(mInputLatencySpin, wxSizerFlags().Border(wxLEFT, 5));
+		mainSizer->Add(latencySizer, wxSizerFlags().Border(wxTOP, 5));
+		mainSizer->Add(mCallbackThruCheck, wxSizerFlags().Border(wxTOP, 5));
 
 		wxGridSizer* outerSizer = new wxGridSizer(1);
 		outerSizer->Add(mainSizer, wxSizerFlags().Border(wxALL, 15).Expand());
@@ -59,6 +95,10 @@ private:
 	void BindEventHandlers()
 	{
 		mInPortList->Bind(wxEVT_RADIOBOX, &MidiSettingsPanel::OnInPortClicked, this);
+		mSequencerThreadCheck->Bind(wxEVT_CHECKBOX, &MidiSettingsPanel::OnSequencerThreadToggled, this);
+		mScheduledOutputCheck->Bind(wxEVT_CHECKBOX, &MidiSettingsPanel::OnScheduledOutputToggled, this);
+		mInputLatencySpin->Bind(wxEVT_SPINCTRL, &MidiSettingsPanel::OnInputLatencyChanged, this);
+		mCallbackThruCheck->Bind(wxEVT_CHECKBOX, &MidiSettingsPanel::OnCallbackThruToggled, this);
 	}
 
 	void OnInPortClicked(wxCommandEvent& evt)
@@ -66,4 +106,31 @@ private:
 		unsigned int p = evt.GetSelection();
 		mAppModel->GetMidiInputManager().SetInputPort(p);
 	}
+
+	void OnSequencerThreadToggled(wxCommandEvent& evt)
+	{
+		if (evt.IsChecked())
+		{
+			mAppModel->StartSequencerThread();
+		}
+		else
+		{
+			mAppModel->StopSequencerThread();
+		}
+	}
+
+	void OnScheduledOutputToggled(wxCommandEvent& evt)
+	{
+		mAppModel->SetOutputLookahead(evt.IsChecked() ? MidiConstants::DEFAULT_OUTPUT_LOOKAHEAD_MS : 0);
+	}
+
+	void OnInputLatencyChanged(wxSpinEvent& evt)
+	{
+		mAppModel->GetRecordingSession().SetInputLatency(evt.GetPosition());
+	}
+
+	void OnCallbackThruToggled(wxCommandEvent& evt)
+	{
+		mAppModel->GetMidiInputManager().SetThruEnabled(evt.IsChecked());
+	}
 };
@@ -46,7 +46,7 @@ private:
 	void OnMidiOutChoice(wxCommandEvent& event)
 	{
 		ubyte port = mMidiOutChoice->GetSelection();
-		mSoundBank.GetMidiOutDevice()->changePort(port);
+		mSoundBank.SetOutputPort(port);
 		mSoundBank.ApplyChannelSettings();
 	}
 
@@ -56,14 +56,14 @@ namespace MidiInterface
 			return mPortNames;
 		}
 	
+		// Polling only works while no callback is set
 		bool checkForMessage()
 		{
-			static double timestamp;
-			static std::vector<unsigned char> message;
-			timestamp = mInstrument->getMessage(&message);
-			if (message.size() > 0)
+			double timestamp = mInstrument->getMessage(&mBuffer);
+			if (mBuffer.size() > 0)
 			{
-				mMessage = MidiMessage(message[0], message[1], message[2]);
+				mBuffer.resize(3, 0);
+				mMessage = MidiMessage(mBuffer[0], mBuffer[1], mBuffer[2]);
 				mMessage.setTimestamp(timestamp);
 				return true;
 			}
@@ -75,9 +75,10 @@ namespace MidiInterface
 			return mMessage;
 		}
 		
-		void setMidiInCallback(void (*callback)(double, std::vector<unsigned char>*, void*))
+		// The callback runs on RtMidi's input thread
+		void setMidiInCallback(void (*callback)(double, std::vector<unsigned char>*, void*), void* userData = nullptr)
 		{
-			mInstrument->setCallback(callback);
+			mInstrument->setCallback(callback, userData);
 		}
 
 		void cancelCallback()
@@ -92,6 +93,7 @@ namespace MidiInterface
 		Range mRange{36, 96};
 		std::vector<std::string> mPortNames;
 		MidiMessage mMessage;
+		std::vector<unsigned char> mBuffer;
 
 		void fillPortNames()
 		{
@@ -1,7 +1,10 @@
 #pragma once
+#include <atomic>
+#include <mutex>
 #include "../RtMidi/RtMidi.h"
 #include "../MidiMessage/MidiMessage.h"
 #include "MidiError.h"
+#include "MidiOutputState.h"
 
 namespace MidiInterface
 {
@@ -24,7 +27,7 @@ namespace MidiInterface
                 }
             }
             fillPortNames();
-            mPlayer->openPort(mPortNum);
+            mPlayer->openPort(mPortNum.load());
         }
 
         ~MidiOut()
@@ -33,21 +36,57 @@ namespace MidiInterface
             delete mPlayer;
         }
            
-        ubyte getCurrentPort()
+        // Readable from any thread while the engine changes the port
+        ubyte getCurrentPort() const
         {
-            return mPortNum;
+            return mPortNum.load(std::memory_order_relaxed);
         }
 
+        // Notes still sounding on the old port are released, the new port starts from unknown state
         void changePort(ubyte p)
         {
+            std::lock_guard<std::mutex> lock(mSendMutex);
+            mState.releaseSoundingNotes([this](const MidiMessage& noteOff) { send(noteOff); });
+            mState.reset();
             mPlayer->closePort();
-            mPortNum = p;
-            mPlayer->openPort(mPortNum);
+            mPortNum.store(p, std::memory_order_relaxed);
+            mPlayer->openPort(p);
         }
 
-        void sendMessage(MidiMessage mm)
+        // Called from the playback engine's thread (which also sends for the GUI, see
+        // SoundBank) and the MIDI thru input callback.
+        // A program or controller value the port already has is not sent again.
+        void sendMessage(const MidiMessage& mm)
         {
-            mPlayer->sendMessage(mm.mData, mm.getMessageSize());
+            std::lock_guard<std::mutex> lock(mSendMutex);
+            if (mState.update(mm))
+            {
+                send(mm);
+            }
+        }
+
+        // Record a message delivered by another path to this port (the playback engine's
+        // ALSA scheduler), so later sends compare against what the device will have.
+        // Nothing is sent, and the message is never dropped as a repeat.
+        void recordScheduled(const MidiMessage& mm)
+        {
+            std::lock_guard<std::mutex> lock(mSendMutex);
+            mState.update(mm);
+        }
+
+        // Scheduled messages were cancelled before delivery: program and controller
+        // values on the device are unknown again, the next send of any value goes out
+        void forgetScheduledSettings()
+        {
+            std::lock_guard<std::mutex> lock(mSendMutex);
+            mState.forgetChannelSettings();
+        }
+
+        // Send NoteOff for each note sounding on this port (nothing when all is quiet)
+        void releaseSoundingNotes()
+        {
+            std::lock_guard<std::mutex> lock(mSendMutex);
+            mState.releaseSoundingNotes([this](const MidiMessage& noteOff) { send(noteOff); });
         }
 
         unsigned int getNumPorts() const
@@ -61,11 +100,18 @@ namespace MidiInterface
         }
 
     private:
-        ubyte mPortNum{0};
+        std::atomic<ubyte> mPortNum{0};
         RtMidiOut* mPlayer;
+        std::mutex mSendMutex;  // Engine thread and thru callback only, held for one send
+        MidiOutputState mState;  // What was sent, guarded by mSendMutex
         ubyte mNumPorts{0};
         std::vector<std::string> mPortNames;
 
+        void send(const MidiMessage& mm)
+        {
+            mPlayer->sendMessage(mm.mData, mm.getMessageSize());
+        }
+
         void fillPortNames()
         {
             for (int i = 0; i < mNumPorts; i++)
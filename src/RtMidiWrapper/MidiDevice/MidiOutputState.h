@@ -0,0 +1,151 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include "../MidiMessage/MidiMessage.h"
+
+namespace MidiInterface
+{
+	/// MidiOutputState remembers what a MIDI output port was last told, so redundant
+	/// messages need not be sent again.
+	///
+	/// Responsibilities:
+	/// - Track sounding notes per channel (NoteOn sets, NoteOff and channel mode messages clear)
+	/// - Track program and controller values per channel, and report repeats
+	/// - Produce NoteOffs for exactly the notes still sounding
+	///
+	/// Fixed-size state, nothing is allocated while messages go through.
+	///
+	/// Usage:
+	///   if (state.update(mm)) port.send(mm);
+	///   state.releaseSoundingNotes([&](const MidiMessage& noteOff) { port.send(noteOff); });
+	class MidiOutputState
+	{
+	public:
+		static constexpr int CHANNELS = 16;
+		static constexpr int NOTES = 128;
+		static constexpr int CONTROLLERS = ALL_SOUND_OFF;  // 120 and up are channel mode messages
+		static constexpr ubyte UNKNOWN = 0xFF;
+
+		// Controllers with side effects beyond their own value
+		static constexpr ubyte BANK_SELECT_MSB = 0;
+		static constexpr ubyte DATA_ENTRY_MSB = 6;
+		static constexpr ubyte BANK_SELECT_LSB = 32;
+		static constexpr ubyte DATA_ENTRY_LSB = 38;
+		static constexpr ubyte DATA_INCREMENT = 96;
+		static constexpr ubyte DATA_DECREMENT = 97;
+		static constexpr ubyte NRPN_LSB = 98;
+		static constexpr ubyte RPN_MSB = 101;
+
+		MidiOutputState()
+		{
+			reset();
+		}
+
+		/// Record a message about to be sent
+		/// @return false if it would change nothing (same program or controller value as last sent)
+		bool update(const MidiMessage& mm)
+		{
+			ubyte channel = mm.getChannel();
+			switch (mm.getEventType())
+			{
+			case NOTE_ON:
+			case NOTE_OFF:
+				mSounding[channel].set(mm.getPitch() & 0x7F, !mm.isNoteOff());
+				return true;
+
+			case PROGRAM_CHANGE:
+				if (mPrograms[channel] == mm.mData[1]) return false;
+				mPrograms[channel] = mm.mData[1];
+				return true;
+
+			case CONTROL_CHANGE:
+				return updateController(channel, mm.mData[1], mm.mData[2]);
+
+			default:
+				return true;
+			}
+		}
+
+		/// Is a note sounding on channel?
+		bool isSounding(ubyte channel, ubyte pitch) const
+		{
+			return mSounding[channel & 0x0F].test(pitch & 0x7F);
+		}
+
+		/// Call send with a NoteOff for every sounding note, then forget them
+		template <typename Send>
+		void releaseSoundingNotes(Send&& send)
+		{
+			for (ubyte c = 0; c < CHANNELS; c++)
+			{
+				if (mSounding[c].none()) continue;
+
+				for (ubyte pitch = 0; pitch < NOTES; pitch++)
+				{
+					if (mSounding[c].test(pitch))
+					{
+						send(MidiMessage::NoteOff(pitch, c));
+					}
+				}
+				mSounding[c].reset();
+			}
+		}
+
+		/// Forget program and controller values, keep sounding notes
+		/// (messages recorded with update were dropped before reaching the device)
+		void forgetChannelSettings()
+		{
+			mPrograms.fill(UNKNOWN);
+			for (auto& controllers : mControllers) controllers.fill(UNKNOWN);
+		}
+
+		/// Forget everything, the device state is unknown (new port)
+		void reset()
+		{
+			for (auto& notes : mSounding) notes.reset();
+			forgetChannelSettings();
+		}
+
+	private:
+		std::array<std::bitset<NOTES>, CHANNELS> mSounding;
+		std::array<ubyte, CHANNELS> mPrograms;
+		std::array<std::array<ubyte, CONTROLLERS>, CHANNELS> mControllers;
+
+		bool updateController(ubyte channel, ubyte controller, ubyte value)
+		{
+			// Data increment/decrement step every time they are sent
+			if (controller == DATA_INCREMENT || controller == DATA_DECREMENT) return true;
+
+			if (controller < CONTROLLERS)
+			{
+				if (mControllers[channel][controller] == value) return false;
+				mControllers[channel][controller] = value;
+
+				if (controller == BANK_SELECT_MSB || controller == BANK_SELECT_LSB)
+				{
+					// The same program number selects a different sound in the new bank
+					mPrograms[channel] = UNKNOWN;
+				}
+				else if (controller >= NRPN_LSB && controller <= RPN_MSB)
+				{
+					// Data entry applies to the newly selected parameter
+					mControllers[channel][DATA_ENTRY_MSB] = UNKNOWN;
+					mControllers[channel][DATA_ENTRY_LSB] = UNKNOWN;
+				}
+				return true;
+			}
+
+			// Channel mode messages always go out
+			if (controller == RESET_CONTROLLERS)
+			{
+				mControllers[channel].fill(UNKNOWN);
+			}
+			else if (controller == ALL_SOUND_OFF || controller >= ALL_NOTES_OFF)
+			{
+				// Omni and mono/poly mode changes silence the channel as well
+				mSounding[channel].reset();
+			}
+			return true;
+		}
+	};
+}
@@ -159,6 +159,12 @@ namespace MidiInterface
 			return (event >= NOTE_OFF && event <= PITCH_BEND && event != PROGRAM_CHANGE);
 		}
 
+		// Channel voice message (status 0x80-0xEF), system messages carry no channel
+		bool isChannelMessage() const
+		{
+			return mData[0] >= 0x80 && mData[0] < 0xF0;
+		}
+
 		// Get the correct MIDI message size based on message type
 		size_t getMessageSize() const
 		{
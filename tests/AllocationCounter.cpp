@@ -0,0 +1,41 @@
+// AllocationCounter.cpp
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+// Single-threaded use only, the tests step the engine on the calling thread
+namespace
+{
+	bool gCounting = false;
+	size_t gAllocations = 0;
+}
+
+void AllocationCounter::Start()
+{
+	gAllocations = 0;
+	gCounting = true;
+}
+
+size_t AllocationCounter::Stop()
+{
+	gCounting = false;
+	return gAllocations;
+}
+
+// operator new[] and the nothrow forms forward here by default
+void* operator new(std::size_t size)
+{
+	if (gCounting) gAllocations++;
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
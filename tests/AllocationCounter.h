@@ -0,0 +1,20 @@
+// AllocationCounter.h
+#pragma once
+#include <cstddef>
+
+/// Counts calls to the global operator new, replaced for the whole MidiWorksTests executable.
+/// Only counts between Start and Stop, everything else allocates as usual.
+///
+/// Usage:
+///   AllocationCounter::Start();
+///   engine.Step();
+///   size_t allocations = AllocationCounter::Stop();
+namespace AllocationCounter
+{
+	/// Count from zero
+	void Start();
+
+	/// Stop counting
+	/// @return Allocations since Start
+	size_t Stop();
+}
@@ -0,0 +1,139 @@
+// PlaybackEngineTests.cpp
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "AppModel/Sequencer/PlaybackEngine.h"
+#include "AppModel/TrackSet/TrackSet.h"
+#include "AllocationCounter.h"
+#include "Test.h"
+
+namespace
+{
+	constexpr uint64_t TPQ = MidiConstants::TICKS_PER_QUARTER;
+
+	/// NoteOn/NoteOff pairs on channel every spacing ticks in [0, endTick)
+	Track MakeNotes(ubyte channel, ubyte pitch, uint64_t spacing, uint64_t endTick)
+	{
+		Track track;
+		for (uint64_t tick = 0; tick < endTick; tick += spacing)
+		{
+			track.push_back({MidiMessage::NoteOn(pitch, 100, channel), tick});
+			track.push_back({MidiMessage::NoteOff(pitch, channel), tick + spacing / 2});
+		}
+		return track;
+	}
+}
+
+// Loop playback with tracks, metronome, loop recording buffer and drum pattern must not
+// allocate once running. At 60000 bpm in 4/16 a beat lasts 250 us, so the long steps
+// render more than CLICK_CAPACITY clicks and every step merges all sources. A millisecond
+// is TPQ ticks here and holds over 80 events, so at least 75 ms of a long step on one
+// side of a wrap are due more than DUE_CAPACITY events.
+TEST(PlaybackEngineStepDoesNotAllocate)
+{
+	constexpr uint64_t LOOP_END = 200 * TPQ;  // 200 ms, 800 beats
+	constexpr auto LONG_STEP = std::chrono::milliseconds(150);  // 600 beats, over 256 on one side of a wrap
+
+	TrackSet trackSet;
+	for (ubyte c = 0; c < 4; c++)
+	{
+		trackSet.GetTrack(c) = MakeNotes(c, static_cast<ubyte>(60 + c), TPQ, LOOP_END);
+	}
+	trackSet.GetTrack(4) = MakeNotes(4, 67, TPQ / 32, LOOP_END);
+	auto loopBuffer = std::make_shared<const Track>(MakeNotes(5, 64, TPQ, LOOP_END));
+	auto drumPattern = std::make_shared<const Track>(MakeNotes(9, 36, TPQ / 2, LOOP_END));
+
+	PlaybackEngine engine;
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetTempoMap, .tempoMap = std::make_shared<const TempoMap>(
+		std::vector<TempoMap::Segment>{{.tick = 0, .tempo = 60000.0, .numerator = 4, .denominator = 16}})});
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetLoop, .loop = {.enabled = true, .startTick = 0, .endTick = LOOP_END}});
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetChannelMask, .channelMask = 0xFFFF});
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetMetronome, .enabled = true});
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetTracks, .tracks = trackSet.GetSnapshot()});
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetLoopBuffer, .events = loopBuffer});
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetDrumPattern, .events = drumPattern});
+	engine.Post(EngineCommand{.type = EngineCommand::Type::Start, .tick = 0, .generation = 1});
+
+	// What the GUI does between steps: drain events, hand the loop buffer back after a wrap
+	int wraps = 0;
+	auto pollEvents = [&]() {
+		EngineEvent event;
+		while (engine.PollEvent(event))
+		{
+			if (event.type != EngineEvent::Type::LoopWrapped) continue;
+			wraps++;
+			engine.Post(EngineCommand{.type = EngineCommand::Type::SetLoopBuffer, .events = loopBuffer});
+		}
+	};
+
+	// Warm-up: apply the setup commands and play a little
+	for (int i = 0; i < 20; i++)
+	{
+		engine.Step();
+		pollEvents();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	size_t allocations = 0;
+	for (int i = 0; i < 400; i++)
+	{
+		AllocationCounter::Start();
+		engine.Step();
+		allocations += AllocationCounter::Stop();
+		pollEvents();
+		std::this_thread::sleep_for(i % 100 == 50 ? LONG_STEP : std::chrono::milliseconds(1));
+	}
+
+	CHECK(allocations == 0);
+	CHECK(wraps >= 2);
+}
+
+// Start and seek chase every track's full state: program, every controller, pitch bend
+// and all 128 notes held on all channels. Sending it must not grow the due buffer.
+TEST(PlaybackEngineChaseDoesNotAllocate)
+{
+	constexpr uint64_t NOTES_END = 100 * TPQ;
+
+	TrackSet trackSet;
+	for (ubyte c = 0; c < MidiConstants::CHANNEL_COUNT; c++)
+	{
+		Track& track = trackSet.GetTrack(c);
+		track.push_back({MidiMessage::ProgramChange(c, c), 0});
+		for (int controller = 0; controller < ChaseIndex::CONTROLLERS; controller++)
+		{
+			track.push_back({MidiMessage::ControlChange(static_cast<ubyte>(controller), 64, c), 0});
+		}
+		track.push_back({MidiMessage(PITCH_BEND | c, 0, 80), 0});
+		for (int pitch = 0; pitch <= MidiConstants::MAX_MIDI_NOTE; pitch++)
+		{
+			track.push_back({MidiMessage::NoteOn(static_cast<ubyte>(pitch), 100, c), TPQ});
+		}
+		for (int pitch = 0; pitch <= MidiConstants::MAX_MIDI_NOTE; pitch++)
+		{
+			track.push_back({MidiMessage::NoteOff(static_cast<ubyte>(pitch), c), NOTES_END});
+		}
+	}
+
+	PlaybackEngine engine;
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetTempoMap, .tempoMap = std::make_shared<const TempoMap>()});
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetChannelMask, .channelMask = 0xFFFF});
+	engine.Post(EngineCommand{.type = EngineCommand::Type::SetTracks, .tracks = trackSet.GetSnapshot()});
+	engine.Step();
+
+	// Start first, then seeks, each chased in a step of its own. Only the steps are counted.
+	EngineEvent event;
+	size_t allocations = 0;
+	for (uint32_t generation = 1; generation < 50; generation++)
+	{
+		engine.Post(generation == 1 ?
+			EngineCommand{.type = EngineCommand::Type::Start, .tick = 2 * TPQ, .generation = generation} :
+			EngineCommand{.type = EngineCommand::Type::Seek, .tick = generation * TPQ, .generation = generation});
+		AllocationCounter::Start();
+		engine.Step();
+		allocations += AllocationCounter::Stop();
+		while (engine.PollEvent(event)) {}
+	}
+
+	CHECK(allocations == 0);
+}
@@ -0,0 +1,56 @@
+// Test.h
+#pragma once
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Minimal test registry for MidiWorksTests, no framework needed.
+///
+/// A TEST registers a function under its name, CHECK records a failure and carries on so
+/// one run reports every broken expectation. CHECK works in release builds, unlike assert.
+///
+/// Usage:
+///   TEST(SeparateOverlappingNotes)
+///   {
+///       CHECK(CountOverlaps(buffer) == 0);
+///   }
+namespace Test
+{
+	struct Case
+	{
+		std::string name;
+		std::function<void()> run;
+	};
+
+	inline std::vector<Case>& Registry()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+
+	inline int& Failures()
+	{
+		static int failures = 0;
+		return failures;
+	}
+
+	struct Registrar
+	{
+		Registrar(const char* name, std::function<void()> run) { Registry().push_back({name, std::move(run)}); }
+	};
+
+	inline void Fail(const char* file, int line, const char* expression)
+	{
+		std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+		Failures()++;
+	}
+}
+
+#define TEST(name) \
+	static void Test_##name(); \
+	static Test::Registrar Registrar_##name(#name, Test_##name); \
+	static void Test_##name()
+
+#define CHECK(expression) \
+	do { if (!(expression)) Test::Fail(__FILE__, __LINE__, #expression); } while (false)
@@ -0,0 +1,28 @@
+// TestMain.cpp
+#include <cstdio>
+#include <string>
+#include "Test.h"
+
+// Runs the test named on the command line, or all of them. ctest registers one entry per test.
+int main(int argc, char* argv[])
+{
+	std::string only = argc > 1 ? argv[1] : "";
+	int run = 0;
+
+	for (const auto& test : Test::Registry())
+	{
+		if (!only.empty() && test.name != only) continue;
+
+		int failuresBefore = Test::Failures();
+		test.run();
+		std::printf("%s %s\n", Test::Failures() == failuresBefore ? "PASS" : "FAIL", test.name.c_str());
+		run++;
+	}
+
+	if (run == 0)
+	{
+		std::fprintf(stderr, "No test named %s\n", only.c_str());
+		return 2;
+	}
+	return Test::Failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+// TrackSetTests.cpp
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include "AppModel/TrackSet/PlaybackMerger.h"
+#include "AppModel/TrackSet/TrackSet.h"
+#include "Test.h"
+
+namespace
+{
+	/// Sorted loop recording buffer of about eventCount events. On four channels the notes
+	/// overlap (NoteOn, NoteOn, NoteOff, NoteOff), so every other NoteOff moves. Every 1000
+	/// events a note starts that is held to the end of the buffer, like a pad held through
+	/// the loop; a search from each NoteOn to its next event would scan the rest of the buffer.
+	Track MakeOverlappingNotes(size_t eventCount)
+	{
+		const size_t heldCount = eventCount / 1000;
+		const size_t groupCount = (eventCount - 2 * heldCount) / 4;
+
+		Track buffer;
+		buffer.reserve(eventCount);
+		size_t held = 0;
+		for (size_t group = 0; group < groupCount; group++)
+		{
+			uint64_t tick = group * 40;
+			if (group % 250 == 0 && held < heldCount)
+			{
+				buffer.push_back({MidiMessage::NoteOn(static_cast<ubyte>(held % 128), 100, static_cast<ubyte>(4 + held / 128)), tick});
+				held++;
+			}
+
+			ubyte channel = static_cast<ubyte>(group % 4);
+			ubyte pitch = static_cast<ubyte>(32 + group % 64);
+			buffer.push_back({MidiMessage::NoteOn(pitch, 100, channel), tick});
+			buffer.push_back({MidiMessage::NoteOn(pitch, 100, channel), tick + 20});
+			buffer.push_back({MidiMessage::NoteOff(pitch, channel), tick + 25});
+			buffer.push_back({MidiMessage::NoteOff(pitch, channel), tick + 30});
+		}
+		for (size_t h = 0; h < held; h++)
+		{
+			buffer.push_back({MidiMessage::NoteOff(static_cast<ubyte>(h % 128), static_cast<ubyte>(4 + h / 128)), groupCount * 40});
+		}
+		return buffer;
+	}
+
+	/// Count NoteOns that start before the previous note of their channel/pitch has ended:
+	/// a second NoteOn with no NoteOff between, or a NoteOff on the NoteOn's own tick.
+	/// Expects a sorted track.
+	size_t CountOverlaps(const Track& track)
+	{
+		struct Key
+		{
+			bool noteOnPending = false;
+			bool ended = false;     // A NoteOff was seen
+			uint64_t endTick = 0;   // Tick of the last NoteOff
+		};
+		std::vector<Key> keys(MidiConstants::TOTAL_CHANNELS * MidiConstants::MIDI_NOTE_COUNT);
+
+		size_t overlaps = 0;
+		for (const auto& event : track)
+		{
+			if (!event.mm.isNoteOn() && !event.mm.isNoteOff()) continue;
+
+			Key& key = keys[event.mm.getChannel() * MidiConstants::MIDI_NOTE_COUNT + event.mm.getPitch()];
+			if (event.mm.isNoteOff())
+			{
+				key.noteOnPending = false;
+				key.ended = true;
+				key.endTick = event.tick;
+				continue;
+			}
+			if (key.noteOnPending || (key.ended && key.endTick >= event.tick)) overlaps++;
+			key.noteOnPending = true;
+		}
+		return overlaps;
+	}
+
+	/// Separate a buffer of about eventCount events, check it, and return the best of a few runs in ns per event
+	double SeparateAndCheck(size_t eventCount)
+	{
+		using Clock = std::chrono::steady_clock;
+		double best = 0.0;
+		for (int run = 0; run < 5; run++)
+		{
+			Track buffer = MakeOverlappingNotes(eventCount);
+			const size_t size = buffer.size();
+			if (run == 0) CHECK(CountOverlaps(buffer) > 0);
+
+			auto start = Clock::now();
+			TrackSet::SeparateOverlappingNotes(buffer);
+			double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+			CHECK(buffer.size() == size);
+			CHECK(std::is_sorted(buffer.begin(), buffer.end(), TrackSet::EventPrecedes));
+			CHECK(CountOverlaps(buffer) == 0);
+			if (run == 0 || ns < best) best = ns;
+		}
+		return best / eventCount;
+	}
+}
+
+// Every overlapping NoteOff must land before the next NoteOn of its channel/pitch.
+// SeparateOverlappingNotes is one sweep plus a merge, so the time per event stays about
+// flat from 10k to 1M events. A pass that scans ahead from held notes costs about 100x
+// more per event at 1M than at 10k; the bound leaves room for cache misses and a busy machine.
+TEST(SeparateOverlappingNotes)
+{
+	double small = SeparateAndCheck(10'000);
+	double large = SeparateAndCheck(1'000'000);
+	std::printf("  10000 events: %.1f ns/event, 1000000 events: %.1f ns/event\n", small, large);
+
+	CHECK(large < small * 10.0);
+}
+
+// A merge limited by out's capacity stops at a tick boundary. Collected pass by pass into
+// a small buffer, the events come out as from one merge with room for all of them.
+TEST(PlaybackMergerCollectsInPasses)
+{
+	constexpr uint64_t END_TICK = 1000;
+
+	// Up to six events on a tick, NoteOns and NoteOffs from three sources
+	std::array<Track, 3> tracks;
+	for (uint64_t tick = 0; tick < END_TICK; tick++)
+	{
+		for (size_t s = 0; s < tracks.size(); s++)
+		{
+			for (uint64_t n = 0; n < (tick + s) % 4; n++)
+			{
+				ubyte pitch = static_cast<ubyte>(60 + n);
+				ubyte channel = static_cast<ubyte>(s);
+				tracks[s].push_back({(tick + n) % 2 ? MidiMessage::NoteOn(pitch, 100, channel) : MidiMessage::NoteOff(pitch, channel), tick});
+			}
+		}
+	}
+
+	auto collect = [&](size_t capacity) {
+		std::array<PlaybackCursor, 3> cursors;
+		PlaybackMerger merger;
+		for (size_t s = 0; s < tracks.size(); s++)
+		{
+			merger.AddSource(tracks[s], cursors[s]);
+		}
+
+		Track all;
+		Track pass;
+		pass.reserve(capacity);
+		const size_t reserved = pass.capacity();
+		uint64_t nextTick = 0;
+		while (nextTick < END_TICK)
+		{
+			uint64_t collected = merger.CollectDue(END_TICK - 1, pass);
+			CHECK(pass.capacity() == reserved);
+			CHECK(pass.empty() || pass.back().tick <= collected);
+			if (collected < nextTick) break;
+
+			all.insert(all.end(), pass.begin(), pass.end());
+			pass.clear();
+			nextTick = collected + 1;
+		}
+		return all;
+	};
+
+	Track whole = collect(3 * END_TICK * 3);
+	Track passes = collect(10);
+	CHECK(passes.size() == whole.size());
+	CHECK(std::equal(passes.begin(), passes.end(), whole.begin(), whole.end(),
+		[](const TimedMidiEvent& a, const TimedMidiEvent& b) { return a.mm == b.mm && a.tick == b.tick; }));
+}
@@ -0,0 +1,49 @@
+// TransportTests.cpp
+#include <cstdint>
+#include <memory>
+#include "AppModel/Transport/Transport.h"
+#include "Test.h"
+
+// Ten minutes of playback in uneven steps, across a tempo change whose quarter note
+// isn't a whole number of ns per tick. The clock must land on 600 s exactly and the tick
+// must match the one worked out from the segments by hand.
+TEST(TransportDrift)
+{
+	constexpr uint64_t TPQ = MidiConstants::TICKS_PER_QUARTER;
+	constexpr uint64_t TOTAL_NS = 600'000'000'000ULL;
+	constexpr uint64_t CHANGE_TICK = 120 * TPQ;  // 60 s at 120 bpm
+
+	Transport transport;
+	transport.SetTempoMap(std::make_shared<const TempoMap>(std::vector<TempoMap::Segment>{
+		{.tick = 0, .tempo = 120.0},
+		{.tick = CHANGE_TICK, .tempo = 90.0}}));
+
+	// Step sizes of 0.2 to 3.2 ms from a fixed LCG, like a jittery sequencer thread
+	uint64_t elapsed = 0;
+	uint64_t lastTick = 0;
+	uint32_t seed = 12345;
+	bool monotonic = true;
+	while (elapsed < TOTAL_NS)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		uint64_t delta = 200'000 + seed % 3'000'001;
+		if (delta > TOTAL_NS - elapsed) delta = TOTAL_NS - elapsed;
+
+		transport.UpdatePlayBack(delta);
+		elapsed += delta;
+
+		if (transport.GetCurrentTick() < lastTick) monotonic = false;
+		lastTick = transport.GetCurrentTick();
+	}
+
+	// 120 bpm: 500'000'000 ns per quarter. 90 bpm: llround(60e9 / 90) = 666'666'667.
+	// Positions are ns * TPQ, a tick lasts nsPerQuarter positions.
+	constexpr uint64_t changePosition = CHANGE_TICK * 500'000'000ULL;
+	constexpr uint64_t expectedTick = CHANGE_TICK + (TOTAL_NS * TPQ - changePosition) / 666'666'667ULL;
+	static_assert(expectedTick == 892'799);
+
+	CHECK(monotonic);
+	CHECK(transport.GetCurrentTimeNs() == TOTAL_NS);
+	CHECK(transport.GetCurrentTick() == expectedTick);
+	CHECK(transport.GetTempoMap()->GetTick(TOTAL_NS * TPQ) == expectedTick);
+}